@@ -21,22 +21,78 @@
 #include "Merge.h"
 
 #include "Record.h"
+#include "SourceLoader.h"
+
+#include <QMutexLocker>
 
 
 namespace glabels
 {
 	namespace merge
 	{
+
+		//
+		// Private
+		//
+		namespace
+		{
+			const int recordsPerProgressUpdate = 1000;
+
+
+			///
+			/// Delete record list, along with its records
+			///
+			void deleteRecordList( QList<Record*>* records )
+			{
+				qDeleteAll( *records );
+				delete records;
+			}
+
+
+			///
+			/// Create new empty record list, to be shared
+			///
+			QSharedPointer< QList<Record*> > newRecordList()
+			{
+				return QSharedPointer< QList<Record*> >( new QList<Record*>, deleteRecordList );
+			}
+		}
+
 	
 		///
 		/// Constructor
 		///
-		Merge::Merge( const Merge* merge ) : mId(merge->mId), mSource(merge->mSource)
+		Merge::Merge()
+			: mSchema(new Schema), mNRecords(0),
+			  mLoadLock(QMutex::Recursive), mIsLoaded(true), mRecordList(newRecordList()),
+			  mNSelected(0), mSelectedValid(true), mHasFieldFilter(false),
+			  mLoader(nullptr), mParentLoader(nullptr)
 		{
-			foreach ( Record* record, merge->mRecordList )
-			{
-				mRecordList << record->clone();
-			}
+		}
+
+
+		///
+		/// Constructor
+		///
+		/// Records are immutable, and shared with the original merge object.  Only
+		/// the selection of records is copied.
+		///
+		Merge::Merge( const Merge* merge )
+			: mId(merge->mId), mSource(merge->mSource), mNRecords(merge->mNRecords),
+			  mLoadLock(QMutex::Recursive),
+			  mHasFieldFilter(merge->mHasFieldFilter), mFieldFilter(merge->mFieldFilter),
+			  mLoader(nullptr), mParentLoader(nullptr)
+		{
+			QMutexLocker locker( &merge->mLoadLock );
+
+			mSchema          = merge->mSchema;
+			mIsLoaded        = merge->mIsLoaded;
+			mRecordList      = merge->mRecordList;
+			mSelection       = merge->mSelection;
+			mNSelected       = merge->mNSelected;
+			mSelectedValid   = merge->mSelectedValid;
+			mSelectedIndices = merge->mSelectedIndices;
+			mSelectedRecords = merge->mSelectedRecords;
 		}
 
 
@@ -45,11 +101,7 @@ namespace glabels
 		///
 		Merge::~Merge()
 		{
-			foreach ( Record* record, mRecordList )
-			{
-				delete record;
-			}
-			mRecordList.clear();
+			cancelLoad();
 		}
 
 
@@ -74,34 +126,138 @@ namespace glabels
 		///
 		/// Set source
 		///
+		/// The source is scanned once, one record at a time, to count its records
+		/// and learn its keys.  The records themselves are only held in memory once
+		/// loaded, see load().  Until then, all records are selected and can be read
+		/// in a single pass using a RecordCursor.
+		///
 		void Merge::setSource( const QString& source )
 		{
-			mSource = source;
+			cancelLoad();
 
-			// Clear out any old records
-			foreach ( Record* record, mRecordList )
 			{
-				delete record;
-			}
-			mRecordList.clear();
+				QMutexLocker locker( &mLoadLock );
 
-			open();
-			for ( Record* record = readNextRecord(); record != nullptr; record = readNextRecord() )
-			{
-				mRecordList.append( record );
+				mSource = source;
+
+				// Clear out any old records
+				mRecordList = newRecordList();
+				clearSelection();
+				mIsLoaded = false;
+
+				open();
+				mNRecords = readRecords( nullptr );
+				close();
 			}
-			close();
 		
 			emit sourceChanged();
 		}
 
 
+		///
+		/// Get number of records
+		///
+		int Merge::nRecords() const
+		{
+			QMutexLocker locker( &mLoadLock );
+			return mIsLoaded ? mRecordList->size() : mNRecords;
+		}
+
+
 		///
 		/// Get record list
 		///
+		/// Loads records, if not already loaded.
+		///
 		const QList<Record*>& Merge::recordList( ) const
 		{
-			return mRecordList;
+			loadRecords();
+			return *mRecordList;
+		}
+
+
+		///
+		/// Get schema
+		///
+		/// Records read from the merge source share this schema, mapping their keys
+		/// to field indices.
+		///
+		const Schema* Merge::schema() const
+		{
+			QMutexLocker locker( &mLoadLock );
+			return mSchema.data();
+		}
+
+
+		///
+		/// Load records, if not already loaded
+		///
+		/// Records are otherwise loaded on first access, by recordList(),
+		/// selectedRecords() and the like, or when changing the selection.  Once
+		/// loaded, all records are selected.
+		///
+		void Merge::load()
+		{
+			loadRecords();
+		}
+
+
+		///
+		/// Are records loaded?
+		///
+		bool Merge::isLoaded() const
+		{
+			QMutexLocker locker( &mLoadLock );
+			return mIsLoaded;
+		}
+
+
+		///
+		/// Load source in background
+		///
+		/// All records of the source are read by a copy of this merge object on a
+		/// worker thread, reporting progress with loadProgress().  Meanwhile, this
+		/// object keeps its current source and records.  Once loading completes,
+		/// the source and its records, all selected, are taken from the copy and
+		/// sourceChanged() is emitted.  loadFinished() is emitted whenever loading
+		/// ends, whether completed or cancelled.
+		///
+		void Merge::loadSource( const QString& source )
+		{
+			cancelLoad();
+
+			mLoader = new SourceLoader( this, source );
+			connect( mLoader, SIGNAL(progress(int,int)), this, SIGNAL(loadProgress(int,int)) );
+			connect( mLoader, SIGNAL(finished()), this, SLOT(onLoaderFinished()) );
+			mLoader->start();
+		}
+
+
+		///
+		/// Cancel loading source in background, if loading
+		///
+		/// The current source and records are kept.  Waits for the worker thread
+		/// to notice, which it does between batches of records.
+		///
+		void Merge::cancelLoad()
+		{
+			if ( mLoader )
+			{
+				disconnect( mLoader, nullptr, this, nullptr );
+				delete mLoader;
+				mLoader = nullptr;
+
+				emit loadFinished();
+			}
+		}
+
+
+		///
+		/// Is source being loaded in background?
+		///
+		bool Merge::isLoading() const
+		{
+			return mLoader != nullptr;
 		}
 
 
@@ -110,8 +266,7 @@ namespace glabels
 		///
 		void Merge::select( Record* record )
 		{
-			record->setSelected( true );
-			emit selectionChanged();
+			setSelected( recordList().indexOf( record ), true );
 		}
 	
 
@@ -120,19 +275,28 @@ namespace glabels
 		///
 		void Merge::unselect( Record* record )
 		{
-			record->setSelected( false );
-			emit selectionChanged();
+			setSelected( recordList().indexOf( record ), false );
 		}
 
 	
 		///
 		/// Select/unselect i'th record
 		///
+		/// Only the selection bitmap and count are updated, the selected indices
+		/// and records are rebuilt on next use.
+		///
 		void Merge::setSelected( int i, bool state )
 		{
-			if ( (i >= 0) && (i < mRecordList.size()) )
+			load();
+
+			QMutexLocker locker( &mLoadLock );
+			if ( (i >= 0) && (i < mSelection.size()) && (mSelection.testBit( i ) != state) )
 			{
-				mRecordList[i]->setSelected( state );
+				mSelection.setBit( i, state );
+				mNSelected += state ? 1 : -1;
+				mSelectedValid = false;
+
+				locker.unlock();
 				emit selectionChanged();
 			}
 		}
@@ -143,11 +307,7 @@ namespace glabels
 		///
 		void Merge::selectAll()
 		{
-			foreach ( Record* record, mRecordList )
-			{
-				record->setSelected( true );
-			}
-			emit selectionChanged();
+			setAllSelected( true );
 		}
 
 	
@@ -156,11 +316,23 @@ namespace glabels
 		///
 		void Merge::unselectAll()
 		{
-			foreach ( Record* record, mRecordList )
+			setAllSelected( false );
+		}
+
+
+		///
+		/// Is i'th record selected?
+		///
+		bool Merge::isSelected( int i ) const
+		{
+			QMutexLocker locker( &mLoadLock );
+			if ( !mIsLoaded )
 			{
-				record->setSelected( false );
+				// All records selected
+				return (i >= 0) && (i < mNRecords);
 			}
-			emit selectionChanged();
+
+			return (i >= 0) && (i < mSelection.size()) && mSelection.testBit( i );
 		}
 
 	
@@ -169,36 +341,376 @@ namespace glabels
 		///
 		int Merge::nSelectedRecords() const
 		{
-			int count = 0;
+			QMutexLocker locker( &mLoadLock );
+			if ( !mIsLoaded )
+			{
+				// All records selected
+				return mNRecords;
+			}
+
+			return mNSelected;
+		}
+
+
+		///
+		/// Return indices of selected records, in order
+		///
+		/// Loads records, if not already loaded.
+		///
+		const QVector<int>& Merge::selectedIndices() const
+		{
+			updateSelected();
+			return mSelectedIndices;
+		}
+
+
+		///
+		/// Return list of selected records, in order
+		///
+		/// Loads records, if not already loaded.
+		///
+		const QList<Record*>& Merge::selectedRecords() const
+		{
+			updateSelected();
+			return mSelectedRecords;
+		}
+
+
+		///
+		/// Set field filter
+		///
+		/// Only fields with the given keys are stored in records read from the
+		/// source.  Other fields read as empty, and backends may skip decoding
+		/// them altogether.  This is typically set to the fields referenced by a
+		/// label, to save memory and time on sources with many unused columns.
+		/// Any records already loaded are loaded again, keeping their selection.
+		///
+		void Merge::setFieldFilter( const QStringList& keys )
+		{
+			mHasFieldFilter = true;
+			mFieldFilter    = keys.toSet();
+			reload();
+		}
+
+
+		///
+		/// Clear field filter, storing all fields
+		///
+		void Merge::clearFieldFilter()
+		{
+			if ( mHasFieldFilter )
+			{
+				mHasFieldFilter = false;
+				mFieldFilter.clear();
+				reload();
+			}
+		}
+
+
+		///
+		/// Is field with given key stored?
+		///
+		bool Merge::isFieldUsed( const QString& key ) const
+		{
+			return !mHasFieldFilter || mFieldFilter.contains( key );
+		}
+
+
+		///
+		/// Is a field filter set?
+		///
+		bool Merge::hasFieldFilter() const
+		{
+			return mHasFieldFilter;
+		}
+
+
+		///
+		/// Get keys of field filter
+		///
+		const QSet<QString>& Merge::fieldFilter() const
+		{
+			return mFieldFilter;
+		}
+
+
+		///
+		/// Read all remaining records of open source
+		///
+		/// Records are appended to records, or discarded if records is nullptr.
+		/// Returns the number of records read.  Backends may override this to read
+		/// in bulk.
+		///
+		int Merge::readRecords( QList<Record*>* records )
+		{
+			int nRecords = 0;
 
-			foreach ( Record* record, mRecordList )
+			for ( Record* record = readNextRecord(); record != nullptr; record = readNextRecord() )
 			{
-				if ( record->isSelected() )
+				if ( records )
 				{
-					count++;
+					records->append( record );
 				}
+				else
+				{
+					delete record;
+				}
+				nRecords++;
+
+				if ( (nRecords % recordsPerProgressUpdate == 0) &&
+				     !updateProgress( nRecords, readFraction() ) )
+				{
+					break;
+				}
+			}
+
+			return nRecords;
+		}
+
+
+		///
+		/// Position open source before its i'th record
+		///
+		/// Returns false if not supported, in which case records can only be read
+		/// in order.  Backends able to read records by index may override this.
+		///
+		bool Merge::seekRecord( int iRecord )
+		{
+			return false;
+		}
+
+
+		///
+		/// Fraction of open source read so far
+		///
+		/// Used to report progress.  Returns a negative value if not known.
+		///
+		double Merge::readFraction() const
+		{
+			return -1;
+		}
+
+
+		///
+		/// Take source, and its loaded records, from another merge object
+		///
+		/// The other object is a copy of this one that has read the source in the
+		/// background.  Backends keeping other state about the source, such as its
+		/// keys, must take that state too.
+		///
+		void Merge::adoptSource( const Merge* merge )
+		{
+			QMutexLocker locker( &mLoadLock );
+
+			mSource     = merge->mSource;
+			mSchema     = merge->mSchema;
+			mRecordList = merge->mRecordList;
+			mNRecords   = merge->mNRecords;
+			mIsLoaded   = merge->mIsLoaded;
+
+			clearSelection();
+			mSelection     = merge->mSelection;
+			mNSelected     = merge->mNSelected;
+			mSelectedValid = false;
+		}
+
+
+		///
+		/// Report progress reading source
+		///
+		/// Backends reading in bulk should call this now and then, with the number
+		/// of records read so far and the fraction of the source read (negative if
+		/// unknown).  Returns false if reading should stop, because loading in the
+		/// background has been cancelled.
+		///
+		bool Merge::updateProgress( int nRecords, double fraction )
+		{
+			return !mParentLoader || mParentLoader->update( nRecords, fraction );
+		}
+
+
+		///
+		/// Read all records of source, in worker thread of loader
+		///
+		/// Reading stops early if cancelled, in which case the loader discards
+		/// this object.
+		///
+		void Merge::readSource( const QString& source )
+		{
+			mSource = source;
+
+			QSharedPointer< QList<Record*> > records = newRecordList();
+			open();
+			readRecords( records.data() );
+			close();
+
+			QMutexLocker locker( &mLoadLock );
+
+			mRecordList = records;
+			mNRecords   = records->size();
+			mIsLoaded   = true;
+
+			// All records selected
+			clearSelection();
+			mSelection  = QBitArray( mNRecords, true );
+			mNSelected  = mNRecords;
+		}
+
+
+		///
+		/// Loader finished slot
+		///
+		void Merge::onLoaderFinished()
+		{
+			// Ignore stale notification from a cancelled loader
+			if ( !mLoader || !mLoader->isFinished() )
+			{
+				return;
 			}
 
-			return count;
+			SourceLoader* loader = mLoader;
+			mLoader = nullptr;
+
+			adoptSource( loader->result() );
+			loader->deleteLater();
+
+			emit sourceChanged();
+			emit loadFinished();
 		}
 
 
 		///
-		/// Return list of selected records
+		/// Load records, if not already loaded
+		///
+		/// Records are read by a copy of this merge object, so that reading its
+		/// source does not disturb the state of this one.  Once loaded, all records
+		/// are selected.
 		///
-		const QList<Record*> Merge::selectedRecords() const
+		void Merge::loadRecords() const
 		{
-			QList<Record*> list;
+			QMutexLocker locker( &mLoadLock );
 
-			foreach ( Record* record, mRecordList )
+			if ( !mIsLoaded )
+			{
+				Merge* reader = clone();
+
+				// New list, as any list of this object may be shared
+				QSharedPointer< QList<Record*> > records = newRecordList();
+				reader->open();
+				reader->readRecords( records.data() );
+				reader->close();
+
+				mRecordList = records;
+				mSchema     = reader->mSchema;
+				delete reader;
+
+				// All records selected
+				mSelection     = QBitArray( mRecordList->size(), true );
+				mNSelected     = mRecordList->size();
+				mSelectedValid = false;
+
+				mIsLoaded = true;
+			}
+		}
+
+
+		///
+		/// Load records again, if loaded, keeping their selection
+		///
+		/// The selection is only kept if the source still has as many records,
+		/// otherwise all records are selected.
+		///
+		void Merge::reload()
+		{
+			if ( isLoaded() && !mSource.isEmpty() )
 			{
-				if ( record->isSelected() )
 				{
-					list.append( record );
+					QMutexLocker locker( &mLoadLock );
+
+					QBitArray selection = mSelection;
+					int       nSelected = mNSelected;
+
+					mIsLoaded = false;
+					loadRecords();
+					mNRecords = mRecordList->size();
+
+					if ( selection.size() == mRecordList->size() )
+					{
+						mSelection = selection;
+						mNSelected = nSelected;
+					}
 				}
+
+				emit selectionChanged();
 			}
+		}
+
+
+		///
+		/// Select or unselect all records
+		///
+		void Merge::setAllSelected( bool state )
+		{
+			load();
+
+			QMutexLocker locker( &mLoadLock );
+			int nSelected = state ? mSelection.size() : 0;
+			if ( mNSelected != nSelected )
+			{
+				mSelection.fill( state );
+				mNSelected     = nSelected;
+				mSelectedValid = false;
 
-			return list;
+				locker.unlock();
+				emit selectionChanged();
+			}
+		}
+
+
+		///
+		/// Forget selection of records
+		///
+		void Merge::clearSelection()
+		{
+			QMutexLocker locker( &mLoadLock );
+
+			mSelection.clear();
+			mNSelected     = 0;
+			mSelectedValid = false;
+			mSelectedIndices.clear();
+			mSelectedRecords.clear();
+		}
+
+
+		///
+		/// Rebuild selected indices and records from selection, if out of date
+		///
+		/// Loads records, if not already loaded.
+		///
+		void Merge::updateSelected() const
+		{
+			QMutexLocker locker( &mLoadLock );
+
+			loadRecords();
+
+			if ( !mSelectedValid )
+			{
+				mSelectedIndices.clear();
+				mSelectedRecords.clear();
+				mSelectedIndices.reserve( mNSelected );
+				mSelectedRecords.reserve( mNSelected );
+
+				for ( int i = 0; i < mSelection.size(); i++ )
+				{
+					if ( mSelection.testBit( i ) )
+					{
+						mSelectedIndices << i;
+						mSelectedRecords << mRecordList->at( i );
+					}
+				}
+
+				mSelectedValid = true;
+			}
 		}
 
 	} // namespace merge
@@ -22,10 +22,17 @@
 #define merge_Merge_h
 
 
+#include "Schema.h"
+
+#include <QBitArray>
+#include <QMutex>
 #include <QObject>
+#include <QSharedPointer>
+#include <QSet>
 #include <QString>
 #include <QStringList>
 #include <QList>
+#include <QVector>
 
 
 namespace glabels
@@ -35,6 +42,7 @@ namespace glabels
 
 		// Forward references
 		class Record;
+		class SourceLoader;
 		
 	
 		///
@@ -49,7 +57,7 @@ namespace glabels
 			// Life Cycle
 			/////////////////////////////////
 		protected:
-			Merge() = default;
+			Merge();
 			Merge( const Merge* merge );
 		public:
 			~Merge() override;
@@ -69,7 +77,26 @@ namespace glabels
 			QString source() const;
 			void setSource( const QString& source );
 
+			int nRecords() const;
 			const QList<Record*>& recordList( ) const;
+			const Schema* schema() const;
+
+
+			/////////////////////////////////
+			// Loading records
+			/////////////////////////////////
+		public:
+			void load();
+			bool isLoaded() const;
+
+
+			/////////////////////////////////
+			// Background loading
+			/////////////////////////////////
+		public:
+			void loadSource( const QString& source );
+			void cancelLoad();
+			bool isLoading() const;
 
 
 			/////////////////////////////////
@@ -81,9 +108,23 @@ namespace glabels
 			void setSelected( int i, bool state = true );
 			void selectAll();
 			void unselectAll();
-	
+
+			bool isSelected( int i ) const;
 			int nSelectedRecords() const;
-			const QList<Record*> selectedRecords() const;
+			const QVector<int>& selectedIndices() const;
+			const QList<Record*>& selectedRecords() const;
+
+
+			/////////////////////////////////
+			// Field filter methods
+			/////////////////////////////////
+		public:
+			void setFieldFilter( const QStringList& keys );
+			void clearFieldFilter();
+		protected:
+			bool isFieldUsed( const QString& key ) const;
+			bool hasFieldFilter() const;
+			const QSet<QString>& fieldFilter() const;
 
 
 			/////////////////////////////////
@@ -96,6 +137,34 @@ namespace glabels
 			virtual void open() = 0;
 			virtual void close() = 0;
 			virtual Record* readNextRecord() = 0;
+			virtual int readRecords( QList<Record*>* records );
+			virtual bool seekRecord( int iRecord );
+			virtual double readFraction() const;
+			virtual void adoptSource( const Merge* merge );
+
+
+			/////////////////////////////////
+			// Protected methods
+			/////////////////////////////////
+		protected:
+			bool updateProgress( int nRecords, double fraction );
+
+
+			/////////////////////////////////
+			// Private methods
+			/////////////////////////////////
+		private:
+			void loadRecords() const;
+			void reload();
+
+			void setAllSelected( bool state );
+			void clearSelection();
+			void updateSelected() const;
+
+			void readSource( const QString& source );
+
+			friend class RecordCursor;
+			friend class SourceLoader;
 		
 
 			/////////////////////////////////
@@ -104,16 +173,43 @@ namespace glabels
 		signals:
 			void sourceChanged();
 			void selectionChanged();
+			void loadProgress( int nRecords, int percent );
+			void loadFinished();
+
+
+			/////////////////////////////////
+			// Private slots
+			/////////////////////////////////
+		private slots:
+			void onLoaderFinished();
 		
 
 			/////////////////////////////////
 			// Private data
 			/////////////////////////////////
 		protected:
-			QString             mId;
+			QString                                  mId;
+			mutable QSharedPointer<Schema>           mSchema;
 		private:
-			QString             mSource;
-			QList<Record*>      mRecordList;
+			QString                                  mSource;
+			int                                      mNRecords;
+
+			// Loaded or built on first use, guarded by mLoadLock
+			mutable QMutex                           mLoadLock;
+			mutable bool                             mIsLoaded;
+			mutable QSharedPointer< QList<Record*> > mRecordList;      // Shared by copies
+
+			mutable QBitArray                        mSelection;       // Selected state of each record
+			mutable int                              mNSelected;
+			mutable bool                             mSelectedValid;   // Selected indices and records up to date?
+			mutable QVector<int>                     mSelectedIndices;
+			mutable QList<Record*>                   mSelectedRecords;
+
+			bool                                     mHasFieldFilter;
+			QSet<QString>                            mFieldFilter;
+
+			SourceLoader*                            mLoader;          // Loading source in background, if any
+			SourceLoader*                            mParentLoader;    // Loader reading this copy, if any
 		};
 
 	}
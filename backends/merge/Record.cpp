@@ -20,6 +20,8 @@
 
 #include "Record.h"
 
+#include <algorithm>
+
 
 namespace glabels
 {
@@ -29,7 +31,15 @@ namespace glabels
 		///
 		/// Constructor
 		///
-		Record::Record() : mSelected( true )
+		Record::Record() : mSchema( new Schema )
+		{
+		}
+
+
+		///
+		/// Constructor
+		///
+		Record::Record( const QSharedPointer<Schema>& schema ) : mSchema( schema )
 		{
 		}
 
@@ -38,7 +48,7 @@ namespace glabels
 		/// Constructor
 		///
 		Record::Record( const Record* record )
-			: QMap<QString,QString>(*record), mSelected(record->mSelected)
+			: mSchema(record->mSchema), mValues(record->mValues)
 		{
 		}
 
@@ -53,20 +63,137 @@ namespace glabels
 
 
 		///
-		/// Is record selected?
+		/// Get schema
+		///
+		const QSharedPointer<Schema>& Record::schema() const
+		{
+			return mSchema;
+		}
+
+
+		///
+		/// Number of fields contained in record
 		///
-		bool Record::isSelected() const
+		int Record::nFields() const
 		{
-			return mSelected;
+			return mValues.size();
+		}
+
+
+		///
+		/// Get value of field
+		///
+		const QString& Record::field( int iField ) const
+		{
+			return mValues[iField];
+		}
+
+
+		///
+		/// Set value of field, extending record as needed
+		///
+		void Record::setField( int iField, const QString& value )
+		{
+			if ( iField >= mValues.size() )
+			{
+				mValues.resize( iField + 1 );
+			}
+			mValues[iField] = value;
+		}
+
+
+		///
+		/// Does record contain key?
+		///
+		bool Record::contains( const QString& key ) const
+		{
+			int iField = mSchema->indexOf( key );
+			return (iField >= 0) && (iField < mValues.size());
+		}
+
+
+		///
+		/// Get value of key, or an empty string if not contained in record
+		///
+		QString Record::value( const QString& key ) const
+		{
+			int iField = mSchema->indexOf( key );
+			if ( (iField >= 0) && (iField < mValues.size()) )
+			{
+				return mValues[iField];
+			}
+			return QString();
+		}
+
+
+		///
+		/// Keys contained in record, in sorted order
+		///
+		QList<QString> Record::keys() const
+		{
+			QList<QString> keys = mSchema->keys().mid( 0, mValues.size() );
+			std::sort( keys.begin(), keys.end() );
+			return keys;
+		}
+
+
+		///
+		/// Values contained in record, in sorted order of their keys
+		///
+		QList<QString> Record::values() const
+		{
+			QList<QString> values;
+			foreach ( const QString& key, keys() )
+			{
+				values << mValues[mSchema->indexOf( key )];
+			}
+			return values;
+		}
+
+
+		///
+		/// Get reference to value of key, adding key to record as needed
+		///
+		QString& Record::operator[]( const QString& key )
+		{
+			int iField = mSchema->addKey( key );
+			if ( iField >= mValues.size() )
+			{
+				mValues.resize( iField + 1 );
+			}
+			return mValues[iField];
+		}
+
+
+		///
+		/// Get value of key
+		///
+		QString Record::operator[]( const QString& key ) const
+		{
+			return value( key );
+		}
+
+
+		///
+		/// Do records contain the same keys and values?
+		///
+		bool Record::operator==( const Record& other ) const
+		{
+			if ( mSchema == other.mSchema )
+			{
+				return mValues == other.mValues;
+			}
+
+			return (keys() == other.keys()) && (values() == other.values());
 		}
 
 
 		///
-		/// Set selected on not selected
+		/// Do records differ?
 		///
-		void Record::setSelected( bool value )
+		bool Record::operator!=( const Record& other ) const
 		{
-			mSelected = value;
+			return !(*this == other);
 		}
 
 	} // namespace merge
@@ -22,8 +22,12 @@
 #define merge_Record_h
 
 
+#include "Schema.h"
+
+#include <QList>
+#include <QSharedPointer>
 #include <QString>
-#include <QMap>
+#include <QVector>
 
 
 namespace glabels
@@ -34,7 +38,15 @@ namespace glabels
 		///
 		/// Merge Record
 		///
-		class Record : public QMap<QString,QString>
+		/// Values are stored by field index, as given by a schema that is normally
+		/// shared by all records of a merge source.  A record contains the fields
+		/// up to the last one set.
+		///
+		/// Records read from a merge source are shared by all copies of the merge
+		/// object, and must not be modified.  Whether a record is selected is a
+		/// property of each merge object instead.
+		///
+		class Record
 		{
 
 			/////////////////////////////////
@@ -42,6 +54,7 @@ namespace glabels
 			/////////////////////////////////
 		public:
 			Record();
+			Record( const QSharedPointer<Schema>& schema );
 			Record( const Record* record );
 
 
@@ -55,15 +68,39 @@ namespace glabels
 			// Properties
 			/////////////////////////////////
 		public:
-			bool isSelected() const;
-			void setSelected( bool value );
+			const QSharedPointer<Schema>& schema() const;
+
+
+			/////////////////////////////////
+			// Field access
+			/////////////////////////////////
+		public:
+			int nFields() const;
+			const QString& field( int iField ) const;
+			void setField( int iField, const QString& value );
+
+			bool contains( const QString& key ) const;
+			QString value( const QString& key ) const;
+			QList<QString> keys() const;
+			QList<QString> values() const;
+
+
+			/////////////////////////////////
+			// Operators
+			/////////////////////////////////
+		public:
+			QString& operator[]( const QString& key );
+			QString operator[]( const QString& key ) const;
+			bool operator==( const Record& other ) const;
+			bool operator!=( const Record& other ) const;
 
 
 			/////////////////////////////////
 			// Private data
 			/////////////////////////////////
 		private:
-			bool                  mSelected;
+			QSharedPointer<Schema> mSchema;
+			QVector<QString>       mValues;
 
 		};
 
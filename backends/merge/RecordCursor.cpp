@@ -0,0 +1,178 @@
+/*  Merge/RecordCursor.cpp
+ *
+ *  Copyright (C) 2015-2016  Jim Evins <evins@snaught.com>
+ *
+ *  This file is part of gLabels-qt.
+ *
+ *  gLabels-qt is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  gLabels-qt is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with gLabels-qt.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "RecordCursor.h"
+
+#include <QMutexLocker>
+
+
+namespace glabels
+{
+	namespace merge
+	{
+
+		///
+		/// Constructor
+		///
+		RecordCursor::RecordCursor()
+			: mNRecords(0), mReader(nullptr), mRecord(nullptr), mIRecord(-1)
+		{
+		}
+
+
+		///
+		/// Constructor
+		///
+		RecordCursor::RecordCursor( const Merge* merge )
+			: mNRecords(0), mReader(nullptr), mRecord(nullptr), mIRecord(-1)
+		{
+			setMerge( merge );
+		}
+
+
+		///
+		/// Destructor
+		///
+		RecordCursor::~RecordCursor()
+		{
+			clear();
+		}
+
+
+		///
+		/// Set merge object, positioning cursor before its first selected record
+		///
+		void RecordCursor::setMerge( const Merge* merge )
+		{
+			clear();
+
+			if ( merge )
+			{
+				QMutexLocker locker( &merge->mLoadLock );
+
+				if ( merge->mIsLoaded )
+				{
+					mRecords  = merge->selectedRecords();
+					mStore    = merge->mRecordList;
+					mNRecords = mRecords.size();
+				}
+				else
+				{
+					// All records are selected until loaded
+					mReader   = merge->clone();
+					mNRecords = merge->nRecords();
+				}
+			}
+		}
+
+
+		///
+		/// Number of selected records
+		///
+		int RecordCursor::size() const
+		{
+			return mNRecords;
+		}
+
+
+		///
+		/// Get i'th selected record
+		///
+		/// Returns nullptr if there is no such record.  The record belongs to the
+		/// cursor, and is only valid until the next call.
+		///
+		Record* RecordCursor::at( int i )
+		{
+			if ( (i < 0) || (i >= mNRecords) )
+			{
+				return nullptr;
+			}
+
+			if ( !mReader )
+			{
+				return mRecords[i];
+			}
+
+			if ( i < mIRecord )
+			{
+				restart();
+			}
+			if ( mIRecord < 0 )
+			{
+				mReader->open();
+			}
+
+			if ( (i > mIRecord + 1) && mReader->seekRecord( i ) )
+			{
+				// Skip directly to record
+				mIRecord = i - 1;
+			}
+
+			while ( mIRecord < i )
+			{
+				delete mRecord;
+				mRecord = mReader->readNextRecord();
+				mIRecord++;
+
+				if ( !mRecord )
+				{
+					// Source is shorter than when scanned
+					mNRecords = mIRecord;
+					return nullptr;
+				}
+			}
+
+			return mRecord;
+		}
+
+
+		///
+		/// Release any records and reader
+		///
+		void RecordCursor::clear()
+		{
+			restart();
+
+			delete mReader;
+			mReader = nullptr;
+
+			mStore.clear();
+			mRecords.clear();
+			mNRecords = 0;
+		}
+
+
+		///
+		/// Position reader before first record
+		///
+		void RecordCursor::restart()
+		{
+			if ( mReader && (mIRecord >= 0) )
+			{
+				mReader->close();
+			}
+
+			delete mRecord;
+			mRecord  = nullptr;
+			mIRecord = -1;
+		}
+
+	} // namespace merge
+} // namespace glabels
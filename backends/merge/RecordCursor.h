@@ -0,0 +1,104 @@
+/*  Merge/RecordCursor.h
+ *
+ *  Copyright (C) 2015-2016  Jim Evins <evins@snaught.com>
+ *
+ *  This file is part of gLabels-qt.
+ *
+ *  gLabels-qt is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  gLabels-qt is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with gLabels-qt.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef merge_RecordCursor_h
+#define merge_RecordCursor_h
+
+
+#include "Merge.h"
+#include "Record.h"
+
+#include <QList>
+#include <QSharedPointer>
+
+
+namespace glabels
+{
+	namespace merge
+	{
+
+		///
+		/// Record Cursor
+		///
+		/// Reads the selected records of a merge object in order.  If the records
+		/// of the merge object have been loaded, they are simply looked up, and
+		/// remain valid even if the merge object is changed or deleted.
+		/// Otherwise, they are read directly from the merge source by a private
+		/// copy of the merge object, holding only the current record in memory.
+		/// Reading forward is then cheap, while reading backward starts over from
+		/// the beginning of the source, unless the merge object can seek directly
+		/// to a record.
+		///
+		class RecordCursor
+		{
+
+			/////////////////////////////////
+			// Life Cycle
+			/////////////////////////////////
+		public:
+			RecordCursor();
+			RecordCursor( const Merge* merge );
+			RecordCursor( const RecordCursor& ) = delete;
+			~RecordCursor();
+
+
+			/////////////////////////////////
+			// Operators
+			/////////////////////////////////
+		public:
+			RecordCursor& operator=( const RecordCursor& ) = delete;
+
+
+			/////////////////////////////////
+			// Public methods
+			/////////////////////////////////
+		public:
+			void setMerge( const Merge* merge );
+
+			int size() const;
+			Record* at( int i );
+
+
+			/////////////////////////////////
+			// Private methods
+			/////////////////////////////////
+		private:
+			void clear();
+			void restart();
+
+
+			/////////////////////////////////
+			// Private data
+			/////////////////////////////////
+		private:
+			int                              mNRecords;
+			QSharedPointer< QList<Record*> > mStore;     // Records of loaded merge
+			QList<Record*>                   mRecords;   // Selected records of loaded merge
+
+			Merge*                           mReader;    // Reader of merge source, if not loaded
+			Record*                          mRecord;    // Current record of reader
+			int                              mIRecord;   // Index of current record of reader
+		};
+
+	}
+}
+
+
+#endif // merge_RecordCursor_h
@@ -0,0 +1,81 @@
+/*  Merge/Schema.cpp
+ *
+ *  Copyright (C) 2013-2016  Jim Evins <evins@snaught.com>
+ *
+ *  This file is part of gLabels-qt.
+ *
+ *  gLabels-qt is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  gLabels-qt is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with gLabels-qt.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "Schema.h"
+
+
+namespace glabels
+{
+	namespace merge
+	{
+
+		///
+		/// Number of fields
+		///
+		int Schema::size() const
+		{
+			return mKeys.size();
+		}
+
+
+		///
+		/// Field index of key, or -1 if not a key of schema
+		///
+		int Schema::indexOf( const QString& key ) const
+		{
+			return mIndexes.value( key, -1 );
+		}
+
+
+		///
+		/// Add key, if new, and return its field index
+		///
+		int Schema::addKey( const QString& key )
+		{
+			int iField = mIndexes.value( key, -1 );
+			if ( iField < 0 )
+			{
+				iField = mKeys.size();
+				mKeys << key;
+				mIndexes[key] = iField;
+			}
+			return iField;
+		}
+
+
+		///
+		/// Key of field
+		///
+		const QString& Schema::key( int iField ) const
+		{
+			return mKeys[iField];
+		}
+
+
+		///
+		/// Keys of all fields, in field order
+		///
+		const QStringList& Schema::keys() const
+		{
+			return mKeys;
+		}
+
+	} // namespace merge
+} // namespace glabels
@@ -0,0 +1,68 @@
+/*  Merge/Schema.h
+ *
+ *  Copyright (C) 2013-2016  Jim Evins <evins@snaught.com>
+ *
+ *  This file is part of gLabels-qt.
+ *
+ *  gLabels-qt is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  gLabels-qt is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with gLabels-qt.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef merge_Schema_h
+#define merge_Schema_h
+
+
+#include <QHash>
+#include <QString>
+#include <QStringList>
+
+
+namespace glabels
+{
+	namespace merge
+	{
+
+		///
+		/// Merge Record Schema
+		///
+		/// Maps each distinct key of a set of records to a field index.  Records
+		/// sharing a schema store only their values, addressed by field index.
+		///
+		class Schema
+		{
+
+			/////////////////////////////////
+			// Public methods
+			/////////////////////////////////
+		public:
+			int size() const;
+			int indexOf( const QString& key ) const;
+			int addKey( const QString& key );
+			const QString& key( int iField ) const;
+			const QStringList& keys() const;
+
+
+			/////////////////////////////////
+			// Private data
+			/////////////////////////////////
+		private:
+			QStringList        mKeys;
+			QHash<QString,int> mIndexes;
+
+		};
+
+	}
+}
+
+
+#endif // merge_Schema_h
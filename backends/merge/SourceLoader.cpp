@@ -0,0 +1,126 @@
+/*  Merge/SourceLoader.cpp
+ *
+ *  Copyright (C) 2016  Jim Evins <evins@snaught.com>
+ *
+ *  This file is part of gLabels-qt.
+ *
+ *  gLabels-qt is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  gLabels-qt is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with gLabels-qt.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "SourceLoader.h"
+
+#include "Merge.h"
+
+
+namespace glabels
+{
+	namespace merge
+	{
+
+		//
+		// Private
+		//
+		namespace
+		{
+			const int recordsPerUpdate = 10000;
+		}
+
+
+		///
+		/// Constructor
+		///
+		SourceLoader::SourceLoader( const Merge* merge, const QString& source, QObject* parent )
+			: QThread(parent), mReader(merge->clone()), mSource(source), mCancelled(0),
+			  mPercent(-1), mNRecords(0)
+		{
+			// Reader reports progress to, and is cancelled through, this loader
+			mReader->mParentLoader = this;
+		}
+
+
+		///
+		/// Destructor
+		///
+		SourceLoader::~SourceLoader()
+		{
+			cancel();
+			wait();
+
+			delete mReader;
+		}
+
+
+		///
+		/// Cancel loading
+		///
+		/// Safe to call from any thread.  Loading stops at the next progress update.
+		///
+		void SourceLoader::cancel()
+		{
+			mCancelled.storeRelease( 1 );
+		}
+
+
+		///
+		/// Has loading been cancelled?
+		///
+		bool SourceLoader::isCancelled() const
+		{
+			return mCancelled.loadAcquire() != 0;
+		}
+
+
+		///
+		/// Get loaded merge object
+		///
+		/// Only valid once finished, if not cancelled.
+		///
+		const Merge* SourceLoader::result() const
+		{
+			return mReader;
+		}
+
+
+		///
+		/// Update progress, from worker thread
+		///
+		/// Called by the merge object being loaded, with the number of records read
+		/// so far, and the fraction of the source read (negative if unknown).
+		/// Returns false if loading has been cancelled.
+		///
+		bool SourceLoader::update( int nRecords, double fraction )
+		{
+			int percent = (fraction < 0) ? -1 : qBound( 0, int( 100*fraction ), 100 );
+
+			if ( (percent != mPercent) || (nRecords - mNRecords >= recordsPerUpdate) )
+			{
+				mPercent  = percent;
+				mNRecords = nRecords;
+				emit progress( nRecords, percent );
+			}
+
+			return !isCancelled();
+		}
+
+
+		///
+		/// Load source, in worker thread
+		///
+		void SourceLoader::run()
+		{
+			mReader->readSource( mSource );
+		}
+
+	} // namespace merge
+} // namespace glabels
@@ -0,0 +1,100 @@
+/*  Merge/SourceLoader.h
+ *
+ *  Copyright (C) 2016  Jim Evins <evins@snaught.com>
+ *
+ *  This file is part of gLabels-qt.
+ *
+ *  gLabels-qt is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  gLabels-qt is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with gLabels-qt.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef merge_SourceLoader_h
+#define merge_SourceLoader_h
+
+
+#include <QAtomicInt>
+#include <QString>
+#include <QThread>
+
+
+namespace glabels
+{
+	namespace merge
+	{
+
+		// Forward references
+		class Merge;
+
+
+		///
+		/// Merge Source Loader
+		///
+		/// Reads all records of a merge source on a worker thread, using a private
+		/// copy of a merge object.  Progress is reported as the records are read,
+		/// and loading may be cancelled at any time.  See Merge::loadSource().
+		///
+		class SourceLoader : public QThread
+		{
+			Q_OBJECT
+
+
+			/////////////////////////////////
+			// Life Cycle
+			/////////////////////////////////
+		public:
+			SourceLoader( const Merge* merge, const QString& source, QObject* parent = nullptr );
+			~SourceLoader() override;
+
+
+			/////////////////////////////////
+			// Signals
+			/////////////////////////////////
+		signals:
+			void progress( int nRecords, int percent );
+
+
+			/////////////////////////////////
+			// Public methods
+			/////////////////////////////////
+		public:
+			void cancel();
+			bool isCancelled() const;
+
+			const Merge* result() const;
+
+			bool update( int nRecords, double fraction );
+
+
+			/////////////////////////////////
+			// Protected methods
+			/////////////////////////////////
+		protected:
+			void run() override;
+
+
+			/////////////////////////////////
+			// Private data
+			/////////////////////////////////
+		private:
+			Merge*     mReader;
+			QString    mSource;
+			QAtomicInt mCancelled;
+			int        mPercent;        // Last reported
+			int        mNRecords;       // Last reported
+		};
+
+	}
+}
+
+
+#endif // merge_SourceLoader_h
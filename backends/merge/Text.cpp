@@ -22,19 +22,147 @@
 
 #include "Record.h"
 
+#include <QAtomicInt>
+#include <QRunnable>
+#include <QThread>
+#include <QThreadPool>
 #include <QtDebug>
 
+#include <algorithm>
+#include <cstring>
+
 
 namespace glabels
 {
 	namespace merge
 	{
 
+		//
+		// Private
+		//
+		namespace
+		{
+			const qint64 parallelMinSize   = 8 * 1024 * 1024;
+			const qint64 parallelChunkSize = 4 * 1024 * 1024;
+
+			const int    linesPerProgressUpdate = 1000;
+			const int    progressIntervalMs     = 100;
+
+
+			///
+			/// Field mask decoding no fields at all
+			///
+			QVector<bool> noFieldsMask()
+			{
+				return QVector<bool>( 1, false );
+			}
+
+
+			///
+			/// Chunk Parser
+			///
+			/// Parses the lines of data starting within [start,end).  The last line
+			/// is parsed to its end, even if that lies beyond the end of the chunk.
+			/// Progress can be followed from other threads while parsing, and parsing
+			/// stops early once cancelled is set.
+			///
+			class ChunkParser : public QRunnable
+			{
+			public:
+				ChunkParser( char delimiter, const QVector<bool>& fieldMask,
+				             const char* data, qint64 size, qint64 start, qint64 end,
+				             const QAtomicInt* cancelled )
+					: mDelimiter(delimiter), mFieldMask(fieldMask),
+					  mData(data), mSize(size), mStart(start), mEnd(end), mEndParsed(start),
+					  mCancelled(cancelled), mNLinesParsed(0), mNBytesParsed(0)
+				{
+				}
+
+				void run() override
+				{
+					TextParser parser( mDelimiter );
+					parser.setFieldMask( mFieldMask );
+					parser.setData( mData + mStart, mSize - mStart );
+
+					while ( (mStart + parser.offset() < mEnd) && !mCancelled->loadAcquire() )
+					{
+						QStringList values = parser.parseLine();
+						if ( values.isEmpty() )
+						{
+							break;
+						}
+						mLines << values;
+
+						mNLinesParsed.storeRelease( mLines.size() );
+						mNBytesParsed.storeRelease( int( parser.offset() ) );
+					}
+
+					mEndParsed = mStart + parser.offset();
+				}
+
+				void restartAt( qint64 start )
+				{
+					mLines.clear();
+					mStart     = start;
+					mEndParsed = start;
+					mNLinesParsed.storeRelease( 0 );
+					mNBytesParsed.storeRelease( 0 );
+				}
+
+				int nLinesParsed() const
+				{
+					return mNLinesParsed.loadAcquire();
+				}
+
+				int nBytesParsed() const
+				{
+					return mNBytesParsed.loadAcquire();
+				}
+
+				qint64 start() const
+				{
+					return mStart;
+				}
+
+				qint64 end() const
+				{
+					return mEndParsed;
+				}
+
+				const QList<QStringList>& lines() const
+				{
+					return mLines;
+				}
+
+			private:
+				char               mDelimiter;
+				QVector<bool>      mFieldMask;
+				const char*        mData;
+				qint64             mSize;
+				qint64             mStart;
+				qint64             mEnd;
+				qint64             mEndParsed;
+				QList<QStringList> mLines;
+
+				const QAtomicInt*  mCancelled;
+				QAtomicInt         mNLinesParsed;   // So far, readable while parsing
+				QAtomicInt         mNBytesParsed;
+			};
+		}
+
+
+		//
+		// Static data
+		//
+		bool Text::msCacheEnabled = false;
+
+
 		///
 		/// Constructor
 		///
 		Text::Text( QChar delimiter, bool line1HasKeys )
-			: mDelimeter(delimiter), mLine1HasKeys(line1HasKeys), mNFieldsMax(0)
+			: mDelimeter(delimiter), mLine1HasKeys(line1HasKeys), mParser(delimiter.toLatin1()),
+			  mICacheRecord(0), mNFieldsMax(0)
 		{
 		}
 
@@ -45,11 +173,34 @@ namespace glabels
 		Text::Text( const Text* merge )
 			: Merge( merge ),
 			  mDelimeter(merge->mDelimeter), mLine1HasKeys(merge->mLine1HasKeys),
+			  mParser(merge->mDelimeter.toLatin1()), mICacheRecord(0),
 			  mKeys(merge->mKeys), mNFieldsMax(merge->mNFieldsMax)
 		{
 		}
 
 
+		///
+		/// Enable or disable caching of parsed sources
+		///
+		/// When enabled, a source is parsed once into a cache file beside it (see
+		/// TextCache), and then read from this cache for as long as the source is
+		/// unchanged.  Disabled by default.
+		///
+		void Text::setCacheEnabled( bool enabled )
+		{
+			msCacheEnabled = enabled;
+		}
+
+
+		///
+		/// Is caching of parsed sources enabled?
+		///
+		bool Text::isCacheEnabled()
+		{
+			return msCacheEnabled;
+		}
+
+
 		///
 		/// Get key list
 		///
@@ -78,15 +229,39 @@ namespace glabels
 		///
 		void Text::open()
 		{
+			// Width of source, as far as known from reading it before
+			int nColumnsSeen = mNFieldsMax;
+
 			mKeys.clear();
+			mColumns.clear();
+			mFieldMask.clear();
+			mFieldsBeyondMask.clear();
 			mNFieldsMax = 0;
+			mSchema = QSharedPointer<Schema>( new Schema );
+
+			mICacheRecord = 0;
+			if ( msCacheEnabled && mCache.open( source(), id() ) )
+			{
+				// Read from cache, rather than parsing source
+				mKeys       = mCache.keys();
+				mNFieldsMax = mKeys.size();
+				foreach ( QString key, mKeys )
+				{
+					mColumns << mSchema->addKey( key );
+				}
+				initFieldMask( mCache.nFieldsMax() );
+				return;
+			}
 
 			mFile.setFileName( source() );
-			if (mFile.open( QIODevice::ReadOnly|QIODevice::Text ))
+			if (mFile.open( QIODevice::ReadOnly ))
 			{
+				mParser.setDevice( &mFile );
+				mParser.setFieldMask( QVector<bool>() );
+
 				if ( mLine1HasKeys )
 				{
-					mKeys = parseLine();
+					mKeys = mParser.parseLine();
 					if ( (mKeys.size() == 1) && (mKeys[0] == "") )
 					{
 						mKeys.clear();
@@ -94,8 +269,25 @@ namespace glabels
 					else
 					{
 						mNFieldsMax = mKeys.size();
+						foreach ( QString key, mKeys )
+						{
+							mColumns << mSchema->addKey( key );
+						}
 					}
 				}
+
+				initFieldMask( nColumnsSeen );
+
+				if ( msCacheEnabled && mCache.beginWrite( source(), id(), mKeys ) )
+				{
+					// All fields are decoded for the cache, masked fields are
+					// left out of records instead.
+					mParser.setFieldMask( QVector<bool>() );
+				}
+				else
+				{
+					mParser.setFieldMask( decodeMask() );
+				}
 			}
 		}
 
@@ -105,6 +297,10 @@ namespace glabels
 		///
 		void Text::close()
 		{
+			mParser.clear();
+			mCache.close();
+			mCache.cancelWrite();
+
 			if ( mFile.isOpen() )
 			{
 				mFile.close();
@@ -117,295 +313,404 @@ namespace glabels
 		///
 		Record* Text::readNextRecord()
 		{
-			QStringList values = parseLine();
-			if ( !values.isEmpty() )
+			if ( mCache.isOpen() )
 			{
-				auto* record = new Record();
-
-				int iField = 0;
-				foreach ( QString value, values )
+				if ( mICacheRecord < mCache.nRecords() )
 				{
-					(*record)[ keyFromIndex(iField) ] = value;
-					iField++;
+					return createRecord( mCache.fields( mICacheRecord++, decodeMask() ) );
 				}
-				mNFieldsMax = std::max( mNFieldsMax, iField );
+				return nullptr;
+			}
 
-				return record;
+			QStringList values = mParser.parseLine();
+			if ( !values.isEmpty() )
+			{
+				return createRecord( values );
 			}
+
+			commitCache();
 			return nullptr;
 		}
 
 
 		///
-		/// Key from field index
+		/// Read all remaining records
 		///
-		QString Text::keyFromIndex( int iField ) const
+		/// Large files are mapped into memory and split into chunks, which are
+		/// parsed concurrently and then stitched back together in order.  Chunks
+		/// are split at the start of a line, which is only a guess at the start of
+		/// a record, since quoted fields may contain newlines.  The guess is checked
+		/// against where the previous chunk actually ended, and if wrong the chunk
+		/// is parsed again from there.  Chunks are parsed a few at a time, so that
+		/// only a bounded amount of parsed data is held in memory at once.  While
+		/// they are parsed, progress is reported every so often from the lines
+		/// parsed so far, and parsing stops early if cancelled.
+		///
+		/// If records is nullptr, lines are only counted, without decoding their
+		/// fields, unless the cache is being written.
+		///
+		int Text::readRecords( QList<Record*>* records )
 		{
-			if ( mLine1HasKeys && ( iField < mKeys.size() ) )
+			if ( mCache.isOpen() )
 			{
-				return mKeys[iField];
+				if ( records )
+				{
+					return Merge::readRecords( records );
+				}
+
+				// Just count the remaining records
+				int nRecords  = mCache.nRecords() - mICacheRecord;
+				mICacheRecord = mCache.nRecords();
+				mNFieldsMax   = std::max( mNFieldsMax, mCache.nFieldsMax() );
+				return nRecords;
 			}
-			else
+
+			bool countOnly = !records && !mCache.isWriting();
+
+			qint64 dataStart = mParser.offset();
+			qint64 size      = mFile.size();
+			int    nThreads  = QThread::idealThreadCount();
+
+			if ( (size - dataStart < parallelMinSize) || (nThreads < 2) || mFile.isSequential() )
 			{
-				return QString::number( iField+1 );
+				return countOnly ? countRecords() : Merge::readRecords( records );
 			}
-		}
 
+			uchar* map = mFile.map( 0, size );
+			if ( !map )
+			{
+				return countOnly ? countRecords() : Merge::readRecords( records );
+			}
+			const char* data = reinterpret_cast<const char*>( map );
 
-		///
-		/// Parse line.                                                     
-		///                                                                           
-		/// Attempt to be a robust parser of various CSV (and similar) formats.       
-		///                                                                           
-		/// Based on CSV format described in RFC 4180 section 2.                      
-		///                                                                           
-		/// Additions to RFC 4180 rules:                                              
-		///   - delimeters and other special characters may be "escaped" by a leading 
-		///     backslash (\)                                                         
-		///   - C escape sequences for newline (\n) and tab (\t) are also translated. 
-		///   - if quoted text is not followed by a delimeter, any additional text is 
-		///     concatenated with quoted portion.                                     
-		///                                                                           
-		/// Returns a list of fields.  A blank line is considered a line with one     
-		/// empty field.  Returns an empty list when done.                             
-		///
-		QStringList Text::parseLine()
-		{
-			QStringList fields;
-	
-			enum State
+			// Guess chunk boundaries
+			QVector<qint64> starts;
+			starts << dataStart;
+			for ( qint64 target = dataStart + parallelChunkSize; target < size; target += parallelChunkSize )
 			{
-				DELIM, QUOTED, QUOTED_QUOTE1, QUOTED_ESCAPED, SIMPLE, SIMPLE_ESCAPED, DONE
-			} state = DELIM;
+				target = std::max( target, starts.last() );
+				auto* newline = static_cast<const char*>( memchr( data + target, '\n', size_t(size - target) ) );
+				if ( !newline || (newline - data + 1 >= size) )
+				{
+					break;
+				}
+				starts << (newline - data + 1);
+			}
+			starts << size;
+
+			int nChunks = starts.size() - 1;
+			char delim  = mDelimeter.toLatin1();
 
-			QByteArray field;
-	
-			while ( state != DONE )
+			QVector<bool> fieldMask = mCache.isWriting() ? QVector<bool>() : decodeMask();
+			if ( countOnly )
 			{
-				char c;
-				if ( mFile.getChar( &c ) )
+				fieldMask = noFieldsMask();
+			}
+
+			QThreadPool pool;
+			pool.setMaxThreadCount( nThreads );
+
+			int        nRecords  = 0;
+			qint64     pos       = dataStart; // End of records stitched so far
+			bool       cancelled = false;
+			QAtomicInt cancelledFlag( 0 );    // Seen by chunk parsers
+
+			for ( int iFirstChunk = 0; (iFirstChunk < nChunks) && !cancelled; iFirstChunk += nThreads )
+			{
+				QList<ChunkParser*> chunks;
+				for ( int i = iFirstChunk; i < std::min( iFirstChunk + nThreads, nChunks ); i++ )
 				{
-					switch (state)
+					auto* chunk = new ChunkParser( delim, fieldMask, data, size, starts[i], starts[i+1],
+					                               &cancelledFlag );
+					chunk->setAutoDelete( false );
+					chunks << chunk;
+					pool.start( chunk );
+				}
+
+				// Report progress, and pass on any cancellation, while chunks are parsed
+				while ( !pool.waitForDone( progressIntervalMs ) )
+				{
+					int    nLines = nRecords;
+					qint64 nBytes = pos - dataStart;
+					foreach ( ChunkParser* chunk, chunks )
 					{
+						nLines += chunk->nLinesParsed();
+						nBytes += chunk->nBytesParsed();
+					}
 
-					case DELIM:
-						switch (c)
-						{
-						case '\n':
-							/* last field is empty. */
-							fields << "";
-							state = DONE;
-							break;
-						case '\r':
-							/* ignore */
-							state = DELIM;
-							break;
-						case '"':
-							/* start a quoted field. */
-							state = QUOTED;
-							break;
-						case '\\':
-							/* simple field, but 1st character is an escape. */
-							state = SIMPLE_ESCAPED;
-							break;
-						default:
-							if ( c == mDelimeter )
-							{
-								/* field is empty. */
-								fields << "";
-								state = DELIM;
-							}
-							else
-							{
-								/* beginning of a simple field. */
-								field.append( c );
-								state = SIMPLE;
-							}
-							break;
-						}
-						break;
+					if ( !cancelled && !updateProgress( nLines, double(nBytes) / double(size - dataStart) ) )
+					{
+						cancelled = true;
+						cancelledFlag.storeRelease( 1 );
+					}
+				}
 
-					case QUOTED:
-						switch (c)
-						{
-						case '"':
-							/* Possible end of field, but could be 1st of a pair. */
-							state = QUOTED_QUOTE1;
-							break;
-						case '\\':
-							/* Escape next character, or special escape, e.g. \n. */
-							state = QUOTED_ESCAPED;
-							break;
-						default:
-							/* Use character literally. */
-							field.append( c );
-							break;
-						}
-						break;
+				if ( cancelled )
+				{
+					qDeleteAll( chunks );
+					break;
+				}
 
-					case QUOTED_QUOTE1:
-						switch (c)
-						{
-						case '\n':
-							/* line ended after quoted item */
-							fields << QString( field );
-							state = DONE;
-							break;
-						case '"':
-							/* second quote, insert and stay quoted. */
-							field.append( c );
-							state = QUOTED;
-							break;
-						case '\r':
-							/* ignore and go to fallback */
-							state = SIMPLE;
-							break;
-						default:
-							if ( c == mDelimeter )
-							{
-								/* end of field. */
-								fields << QString( field );
-								field.clear();
-								state = DELIM;
-							}
-							else
-							{
-								/* fallback if not a delim or another quote. */
-								field.append( c );
-								state = SIMPLE;
-							}
-							break;
-						}
-						break;
+				foreach ( ChunkParser* chunk, chunks )
+				{
+					if ( chunk->start() != pos )
+					{
+						// Chunk did not start on a record boundary, parse it again
+						chunk->restartAt( pos );
+						chunk->run();
+					}
 
-					case QUOTED_ESCAPED:
-						switch (c)
+					foreach ( const QStringList& values, chunk->lines() )
+					{
+						if ( countOnly )
 						{
-						case 'n':
-							/* Decode "\n" as newline. */
-							field.append( '\n' );
-							state = QUOTED;
-							break;
-						case 't':
-							/* Decode "\t" as tab. */
-							field.append( '\t' );
-							state = QUOTED;
-							break;
-						default:
-							/* Use character literally. */
-							field.append( c );
-							state = QUOTED;
-							break;
+							countFields( values.size() );
 						}
-						break;
-
-					case SIMPLE:
-						switch (c)
+						else
 						{
-						case '\n':
-							/* line ended */
-							fields << QString( field );
-							state = DONE;
-							break;
-						case '\r':
-							/* ignore */
-							state = SIMPLE;
-							break;
-						case '\\':
-							/* Escape next character, or special escape, e.g. \n. */
-							state = SIMPLE_ESCAPED;
-							break;
-						default:
-							if ( c == mDelimeter )
+							Record* record = createRecord( values );
+							if ( records )
 							{
-								/* end of field. */
-								fields << QString( field );
-								field.clear();
-								state = DELIM;
+								records->append( record );
 							}
 							else
 							{
-								/* Use character literally. */
-								field.append( c );
-								state = SIMPLE;
+								delete record;
 							}
-							break;
 						}
-						break;
+						nRecords++;
+					}
 
-					case SIMPLE_ESCAPED:
-						switch (c)
-						{
-						case 'n':
-							/* Decode "\n" as newline. */
-							field.append( '\n' );
-							state = SIMPLE;
-							break;
-						case 't':
-							/* Decode "\t" as tab. */
-							field.append( '\t' );
-							state = SIMPLE;
-							break;
-						default:
-							/* Use character literally. */
-							field.append( (char)c );
-							state = SIMPLE;
-							break;
-						}
-						break;
+					pos = chunk->end();
 
-					default:
-						qWarning( "merge::Text::parseLine()::Should not be reached! #1" );
+					if ( !updateProgress( nRecords, double(pos - dataStart) / double(size - dataStart) ) )
+					{
+						cancelled = true;
 						break;
 					}
+				}
+
+				qDeleteAll( chunks );
+			}
+
+			mFile.unmap( map );
+
+			// Leave parser at end of data
+			mFile.seek( size );
+			mParser.setDevice( &mFile );
+
+			if ( cancelled )
+			{
+				// Incomplete
+				mCache.cancelWrite();
+			}
+			else
+			{
+				commitCache();
+			}
+
+			return nRecords;
+		}
+
+
+		///
+		/// Position before i'th record
+		///
+		/// Records can only be read by index from the cache.
+		///
+		bool Text::seekRecord( int iRecord )
+		{
+			if ( mCache.isOpen() && (iRecord >= 0) && (iRecord <= mCache.nRecords()) )
+			{
+				mICacheRecord = iRecord;
+				return true;
+			}
+			return false;
+		}
+
+
+		///
+		/// Fraction of source read so far
+		///
+		double Text::readFraction() const
+		{
+			if ( mCache.isOpen() )
+			{
+				return (mCache.nRecords() > 0) ? double(mICacheRecord) / mCache.nRecords() : 1.0;
+			}
+
+			if ( mFile.isOpen() && !mFile.isSequential() && (mFile.size() > 0) )
+			{
+				return double(mParser.offset()) / mFile.size();
+			}
+
+			return -1;
+		}
+
+
+		///
+		/// Take source, and its keys, from another merge object
+		///
+		void Text::adoptSource( const Merge* merge )
+		{
+			Merge::adoptSource( merge );
+
+			auto* text = dynamic_cast<const Text*>( merge );
+			if ( text )
+			{
+				mKeys       = text->mKeys;
+				mNFieldsMax = text->mNFieldsMax;
+			}
+		}
+
+
+		///
+		/// Create record from the values of a line
+		///
+		/// Lines must be given in order, since the first line to have a given
+		/// column defines the key of that column.
+		///
+		Record* Text::createRecord( const QStringList& values )
+		{
+			if ( mCache.isWriting() )
+			{
+				mCache.write( values );
+			}
+
+			auto* record = new Record( mSchema );
 
+			int iField = 0;
+			foreach ( QString value, values )
+			{
+				if ( iField >= mColumns.size() )
+				{
+					mColumns << mSchema->addKey( keyFromIndex(iField) );
 				}
-				else
+				bool isUsed = mFieldMask.isEmpty() ||
+				              ( (iField < mFieldMask.size()) ? mFieldMask[iField] : mFieldsBeyondMask.contains( iField ) );
+				if ( isUsed )
 				{
-					/* Handle EOF (could also be an error while reading). */
-					switch (state)
-					{
+					record->setField( mColumns[iField], value );
+				}
+				iField++;
+			}
+			mNFieldsMax = std::max( mNFieldsMax, iField );
 
-					case DELIM:
-						/* EOF, no more lines. */
-						break;
+			return record;
+		}
 
-					case QUOTED:
-						/* File ended midway through quoted item. Truncate field. */
-						fields << QString( field );
-						break;
 
-					case QUOTED_QUOTE1:
-						/* File ended after quoted item. */
-						fields << QString( field );
-						break;
+		///
+		/// Count remaining lines of source, without decoding their fields
+		///
+		int Text::countRecords()
+		{
+			mParser.setFieldMask( noFieldsMask() );
 
-					case QUOTED_ESCAPED:
-						/* File ended midway through quoted item. Truncate field. */
-						fields << QString( field );
-						break;
+			int nRecords = 0;
+			for ( QStringList values = mParser.parseLine(); !values.isEmpty(); values = mParser.parseLine() )
+			{
+				countFields( values.size() );
+				nRecords++;
 
-					case SIMPLE:
-						/* File ended after simple item. */
-						fields << QString( field );
-						break;
+				if ( (nRecords % linesPerProgressUpdate == 0) &&
+				     !updateProgress( nRecords, readFraction() ) )
+				{
+					break;
+				}
+			}
 
-					case SIMPLE_ESCAPED:
-						/* File ended midway through escaped item. */
-						fields << QString( field );
-						break;
+			mParser.setFieldMask( decodeMask() );
 
-					default:
-						qWarning( "merge::Text::parseLine()::Should not be reached! #2" );
-						break;
+			return nRecords;
+		}
+
+
+		///
+		/// Account for the columns of a line, as createRecord() would
+		///
+		void Text::countFields( int nFields )
+		{
+			while ( mColumns.size() < nFields )
+			{
+				mColumns << mSchema->addKey( keyFromIndex( mColumns.size() ) );
+			}
+			mNFieldsMax = std::max( mNFieldsMax, nFields );
+		}
+
+
+		///
+		/// Initialize mask of columns to store, from field filter
+		///
+		/// The mask covers the header and the columns seen when the source was
+		/// last read, if any.  Columns beyond the mask are keyed by number, so
+		/// any such column is only stored if its numbered key is in the filter.
+		///
+		void Text::initFieldMask( int nColumnsSeen )
+		{
+			mFieldMask.clear();
+			mFieldsBeyondMask.clear();
+
+			if ( hasFieldFilter() )
+			{
+				int nColumns = std::max( std::max( mKeys.size(), nColumnsSeen ), 1 );
+
+				mFieldMask.resize( nColumns );
+				for ( int iField = 0; iField < nColumns; iField++ )
+				{
+					mFieldMask[iField] = isFieldUsed( keyFromIndex(iField) );
+				}
+
+				foreach ( const QString& key, fieldFilter() )
+				{
+					bool ok;
+					int iField = key.toInt( &ok ) - 1;
+					if ( ok && (iField >= nColumns) && (keyFromIndex( iField ) == key) )
+					{
+						mFieldsBeyondMask << iField;
 					}
-			
-					state = DONE;
 				}
 			}
-	
+		}
 
-			return fields;
+
+		///
+		/// Mask of columns to decode
+		///
+		/// If any filtered column lies beyond the field mask, all columns are
+		/// decoded, and createRecord() leaves out those not stored.
+		///
+		QVector<bool> Text::decodeMask() const
+		{
+			return mFieldsBeyondMask.isEmpty() ? mFieldMask : QVector<bool>();
+		}
+
+
+		///
+		/// Commit cache being written, once all of source has been read
+		///
+		void Text::commitCache()
+		{
+			if ( mCache.isWriting() )
+			{
+				mCache.commitWrite( mNFieldsMax );
+			}
+		}
+
+
+		///
+		/// Key from field index
+		///
+		QString Text::keyFromIndex( int iField ) const
+		{
+			if ( mLine1HasKeys && ( iField < mKeys.size() ) )
+			{
+				return mKeys[iField];
+			}
+			else
+			{
+				return QString::number( iField+1 );
+			}
 		}
 
 	} // namespace merge
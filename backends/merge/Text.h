@@ -22,8 +22,12 @@
 #define merge_Text_h
 
 #include "Merge.h"
+#include "TextCache.h"
+#include "TextParser.h"
 
 #include <QFile>
+#include <QSet>
+#include <QVector>
 
 
 namespace glabels
@@ -46,6 +50,14 @@ namespace glabels
 			~Text() override = default;
 
 
+			/////////////////////////////////
+			// Cache
+			/////////////////////////////////
+		public:
+			static void setCacheEnabled( bool enabled );
+			static bool isCacheEnabled();
+
+
 			/////////////////////////////////
 			// Implementation of virtual methods
 			/////////////////////////////////
@@ -56,13 +68,22 @@ namespace glabels
 			void open() override;
 			void close() override;
 			Record* readNextRecord() override;
+			int readRecords( QList<Record*>* records ) override;
+			bool seekRecord( int iRecord ) override;
+			double readFraction() const override;
+			void adoptSource( const Merge* merge ) override;
 
 
 			/////////////////////////////////
 			// Private methods
 			/////////////////////////////////
 			QString keyFromIndex( int iField ) const;
-			QStringList parseLine();
+			Record* createRecord( const QStringList& values );
+			int countRecords();
+			void countFields( int nFields );
+			void initFieldMask( int nColumnsSeen );
+			QVector<bool> decodeMask() const;
+			void commitCache();
 	
 
 			/////////////////////////////////
@@ -73,8 +94,17 @@ namespace glabels
 			bool  mLine1HasKeys;
 
 			QFile          mFile;
+			TextParser     mParser;
+			TextCache      mCache;
+			int            mICacheRecord;  // Next record read from cache
+
 			QStringList    mKeys;
+			QVector<int>   mColumns;    // Schema field index of each column
+			QVector<bool>  mFieldMask;  // Columns stored, if filtered
+			QSet<int>      mFieldsBeyondMask;  // Filtered columns not seen yet
 			int            mNFieldsMax;
+
+			static bool    msCacheEnabled;
 		};
 
 	}
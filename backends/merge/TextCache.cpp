@@ -0,0 +1,453 @@
+/*  Merge/TextCache.cpp
+ *
+ *  Copyright (C) 2016  Jim Evins <evins@snaught.com>
+ *
+ *  This file is part of gLabels-qt.
+ *
+ *  gLabels-qt is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  gLabels-qt is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with gLabels-qt.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "TextCache.h"
+
+#include <QDataStream>
+#include <QDateTime>
+#include <QFileInfo>
+#include <QtEndian>
+#include <QtDebug>
+
+
+namespace glabels
+{
+	namespace merge
+	{
+
+		//
+		// Private
+		//
+		namespace
+		{
+			const quint32 cacheMagic   = 0x474c4d43; // "GLMC"
+			const qint32  cacheVersion = 1;
+
+			const qint64  trailerSize   = 8 + 4 + 4 + 4;
+			const int     flushSize     = 1024 * 1024;
+
+
+			///
+			/// Append little endian 32-bit value
+			///
+			void appendUInt32( QByteArray& data, quint32 value )
+			{
+				uchar bytes[4];
+				qToLittleEndian<quint32>( value, bytes );
+				data.append( reinterpret_cast<const char*>( bytes ), 4 );
+			}
+
+
+			///
+			/// Append little endian 64-bit value
+			///
+			void appendInt64( QByteArray& data, qint64 value )
+			{
+				uchar bytes[8];
+				qToLittleEndian<qint64>( value, bytes );
+				data.append( reinterpret_cast<const char*>( bytes ), 8 );
+			}
+		}
+
+
+		///
+		/// Constructor
+		///
+		TextCache::TextCache()
+			: mMap(nullptr), mMapSize(0), mIndex(nullptr), mNFieldsMax(0), mNRecords(0),
+			  mWriter(nullptr), mWriteSourceSize(0), mWriteSourceMTime(0)
+		{
+		}
+
+
+		///
+		/// Destructor
+		///
+		TextCache::~TextCache()
+		{
+			close();
+			cancelWrite();
+		}
+
+
+		///
+		/// Cache file name for source
+		///
+		QString TextCache::fileName( const QString& source )
+		{
+			QFileInfo fileInfo( source );
+			return fileInfo.absolutePath() + "/." + fileInfo.fileName() + ".glabels-cache";
+		}
+
+
+		///
+		/// Open cache of source, if valid
+		///
+		/// The cache is valid if it was written for the same source path, size and
+		/// modification time, by the merge backend with the given id.  Returns
+		/// false if there is no valid cache.
+		///
+		bool TextCache::open( const QString& source, const QString& id )
+		{
+			close();
+
+			QString path;
+			qint64  size, mTime;
+			if ( !sourceInfo( source, path, size, mTime ) )
+			{
+				return false;
+			}
+
+			mFile.setFileName( fileName( source ) );
+			if ( !mFile.open( QIODevice::ReadOnly ) )
+			{
+				return false;
+			}
+
+			QDataStream in( &mFile );
+			in.setVersion( QDataStream::Qt_5_0 );
+
+			quint32 magic;
+			qint32  version;
+			QString cacheId, cachePath;
+			qint64  cacheSize, cacheMTime;
+			in >> magic >> version;
+			if ( (magic != cacheMagic) || (version != cacheVersion) )
+			{
+				close();
+				return false;
+			}
+			in >> cacheId >> cachePath >> cacheSize >> cacheMTime >> mKeys;
+			if ( (in.status() != QDataStream::Ok) ||
+			     (cacheId != id) || (cachePath != path) || (cacheSize != size) || (cacheMTime != mTime) )
+			{
+				close();
+				return false;
+			}
+
+			qint64 dataStart = mFile.pos();
+			mMapSize = mFile.size();
+			if ( mMapSize < dataStart + trailerSize )
+			{
+				close();
+				return false;
+			}
+
+			mMap = mFile.map( 0, mMapSize );
+			if ( !mMap )
+			{
+				close();
+				return false;
+			}
+
+			const uchar* trailer = mMap + mMapSize - trailerSize;
+			qint64 indexOffset = qFromLittleEndian<qint64>( trailer );
+			mNRecords          = qFromLittleEndian<qint32>( trailer + 8 );
+			mNFieldsMax        = qFromLittleEndian<qint32>( trailer + 12 );
+			magic              = qFromLittleEndian<quint32>( trailer + 16 );
+
+			if ( (magic != cacheMagic) || (mNRecords < 0) || (indexOffset < dataStart) ||
+			     (indexOffset + 8*qint64(mNRecords) + trailerSize != mMapSize) )
+			{
+				// Truncated or otherwise damaged
+				close();
+				return false;
+			}
+			mIndex = mMap + indexOffset;
+
+			return true;
+		}
+
+
+		///
+		/// Close cache
+		///
+		void TextCache::close()
+		{
+			if ( mMap )
+			{
+				mFile.unmap( const_cast<uchar*>( mMap ) );
+			}
+			if ( mFile.isOpen() )
+			{
+				mFile.close();
+			}
+
+			mMap        = nullptr;
+			mMapSize    = 0;
+			mIndex      = nullptr;
+			mKeys.clear();
+			mNFieldsMax = 0;
+			mNRecords   = 0;
+		}
+
+
+		///
+		/// Is cache open for reading?
+		///
+		bool TextCache::isOpen() const
+		{
+			return mIndex != nullptr;
+		}
+
+
+		///
+		/// Keys read from first line of source, if any
+		///
+		const QStringList& TextCache::keys() const
+		{
+			return mKeys;
+		}
+
+
+		///
+		/// Greatest number of fields in any line of source
+		///
+		int TextCache::nFieldsMax() const
+		{
+			return mNFieldsMax;
+		}
+
+
+		///
+		/// Number of records of source
+		///
+		int TextCache::nRecords() const
+		{
+			return mNRecords;
+		}
+
+
+		///
+		/// Get fields of i'th record
+		///
+		/// Only fields whose mask entry is true are decoded, as for TextParser.
+		///
+		QStringList TextCache::fields( int iRecord, const QVector<bool>& mask ) const
+		{
+			QStringList fields;
+
+			if ( !isOpen() || (iRecord < 0) || (iRecord >= mNRecords) )
+			{
+				return fields;
+			}
+
+			const uchar* p   = mMap + qFromLittleEndian<qint64>( mIndex + 8*qint64(iRecord) );
+			const uchar* end = mIndex;
+
+			if ( (p < mMap) || (p + 4 > end) )
+			{
+				qWarning() << "Damaged merge cache" << mFile.fileName();
+				return fields;
+			}
+			quint32 nFields = qFromLittleEndian<quint32>( p );
+			p += 4;
+
+			for ( quint32 iField = 0; iField < nFields; iField++ )
+			{
+				if ( p + 4 > end )
+				{
+					break;
+				}
+				quint32 nBytes = qFromLittleEndian<quint32>( p );
+				p += 4;
+				if ( qint64(nBytes) > end - p )
+				{
+					break;
+				}
+
+				if ( mask.isEmpty() || ( (int(iField) < mask.size()) && mask[iField] ) )
+				{
+					fields << QString::fromUtf8( reinterpret_cast<const char*>( p ), int(nBytes) );
+				}
+				else
+				{
+					fields << QString();
+				}
+				p += nBytes;
+			}
+
+			return fields;
+		}
+
+
+		///
+		/// Begin writing cache of source
+		///
+		/// Returns false if the cache cannot be written, e.g. if the directory of
+		/// the source is read-only.  The cache only replaces any existing cache
+		/// once committed.
+		///
+		bool TextCache::beginWrite( const QString& source, const QString& id, const QStringList& keys )
+		{
+			cancelWrite();
+
+			QString path;
+			if ( !sourceInfo( source, path, mWriteSourceSize, mWriteSourceMTime ) )
+			{
+				return false;
+			}
+
+			mWriter = new QSaveFile( fileName( source ) );
+			if ( !mWriter->open( QIODevice::WriteOnly ) )
+			{
+				delete mWriter;
+				mWriter = nullptr;
+				return false;
+			}
+			mWriteSource = source;
+
+			QDataStream out( mWriter );
+			out.setVersion( QDataStream::Qt_5_0 );
+			out << cacheMagic << cacheVersion;
+			out << id << path << mWriteSourceSize << mWriteSourceMTime << keys;
+
+			mOffsets.clear();
+			mRecordData.clear();
+
+			return true;
+		}
+
+
+		///
+		/// Write fields of next record
+		///
+		void TextCache::write( const QStringList& fields )
+		{
+			if ( !mWriter )
+			{
+				return;
+			}
+
+			mOffsets << mWriter->pos() + mRecordData.size();
+
+			appendUInt32( mRecordData, quint32( fields.size() ) );
+			foreach ( const QString& field, fields )
+			{
+				QByteArray utf8 = field.toUtf8();
+				appendUInt32( mRecordData, quint32( utf8.size() ) );
+				mRecordData.append( utf8 );
+			}
+
+			if ( mRecordData.size() >= flushSize )
+			{
+				mWriter->write( mRecordData );
+				mRecordData.clear();
+			}
+		}
+
+
+		///
+		/// Finish writing cache, replacing any existing cache
+		///
+		/// The cache is discarded if its source has changed since writing began.
+		///
+		bool TextCache::commitWrite( int nFieldsMax )
+		{
+			if ( !mWriter )
+			{
+				return false;
+			}
+
+			QString path;
+			qint64  size, mTime;
+			if ( !sourceInfo( mWriteSource, path, size, mTime ) ||
+			     (size != mWriteSourceSize) || (mTime != mWriteSourceMTime) )
+			{
+				cancelWrite();
+				return false;
+			}
+
+			mWriter->write( mRecordData );
+			mRecordData.clear();
+
+			qint64 indexOffset = mWriter->pos();
+
+			QByteArray tail;
+			tail.reserve( 8*mOffsets.size() + trailerSize );
+			foreach ( qint64 offset, mOffsets )
+			{
+				appendInt64( tail, offset );
+			}
+			appendInt64( tail, indexOffset );
+			appendUInt32( tail, quint32( mOffsets.size() ) );
+			appendUInt32( tail, quint32( nFieldsMax ) );
+			appendUInt32( tail, cacheMagic );
+			mWriter->write( tail );
+
+			bool ok = mWriter->commit();
+			if ( !ok )
+			{
+				qWarning() << "Could not write merge cache" << mWriter->fileName();
+			}
+
+			delete mWriter;
+			mWriter = nullptr;
+			mOffsets.clear();
+
+			return ok;
+		}
+
+
+		///
+		/// Abandon writing cache, leaving any existing cache in place
+		///
+		void TextCache::cancelWrite()
+		{
+			if ( mWriter )
+			{
+				mWriter->cancelWriting();
+				delete mWriter;
+				mWriter = nullptr;
+			}
+			mOffsets.clear();
+			mRecordData.clear();
+		}
+
+
+		///
+		/// Is cache being written?
+		///
+		bool TextCache::isWriting() const
+		{
+			return mWriter != nullptr;
+		}
+
+
+		///
+		/// Get identifying information of source file
+		///
+		bool TextCache::sourceInfo( const QString& source, QString& path, qint64& size, qint64& mTime )
+		{
+			QFileInfo fileInfo( source );
+			if ( !fileInfo.isFile() )
+			{
+				return false;
+			}
+
+			path  = fileInfo.absoluteFilePath();
+			size  = fileInfo.size();
+			mTime = fileInfo.lastModified().toMSecsSinceEpoch();
+
+			return true;
+		}
+
+	} // namespace merge
+} // namespace glabels
@@ -0,0 +1,121 @@
+/*  Merge/TextCache.h
+ *
+ *  Copyright (C) 2016  Jim Evins <evins@snaught.com>
+ *
+ *  This file is part of gLabels-qt.
+ *
+ *  gLabels-qt is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  gLabels-qt is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with gLabels-qt.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef merge_TextCache_h
+#define merge_TextCache_h
+
+
+#include <QFile>
+#include <QSaveFile>
+#include <QStringList>
+#include <QVector>
+
+
+namespace glabels
+{
+	namespace merge
+	{
+
+		///
+		/// Text Merge Source Cache
+		///
+		/// A binary file beside a text merge source, holding the fields of each
+		/// of its lines, already parsed and decoded.  The cache is only valid for
+		/// the source path, size and modification time that it was written for,
+		/// and for the same merge backend.
+		///
+		/// The file is memory mapped when read, and ends with an index of record
+		/// offsets, so that any record can be fetched directly by its index.
+		///
+		class TextCache
+		{
+
+			/////////////////////////////////
+			// Life Cycle
+			/////////////////////////////////
+		public:
+			TextCache();
+			TextCache( const TextCache& ) = delete;
+			~TextCache();
+
+
+			/////////////////////////////////
+			// Operators
+			/////////////////////////////////
+		public:
+			TextCache& operator=( const TextCache& ) = delete;
+
+
+			/////////////////////////////////
+			// Public methods
+			/////////////////////////////////
+		public:
+			static QString fileName( const QString& source );
+
+			bool open( const QString& source, const QString& id );
+			void close();
+			bool isOpen() const;
+
+			const QStringList& keys() const;
+			int nFieldsMax() const;
+			int nRecords() const;
+			QStringList fields( int iRecord, const QVector<bool>& mask ) const;
+
+			bool beginWrite( const QString& source, const QString& id, const QStringList& keys );
+			void write( const QStringList& fields );
+			bool commitWrite( int nFieldsMax );
+			void cancelWrite();
+			bool isWriting() const;
+
+
+			/////////////////////////////////
+			// Private methods
+			/////////////////////////////////
+		private:
+			static bool sourceInfo( const QString& source, QString& path, qint64& size, qint64& mTime );
+
+
+			/////////////////////////////////
+			// Private data
+			/////////////////////////////////
+		private:
+			// Reading
+			QFile           mFile;
+			const uchar*    mMap;
+			qint64          mMapSize;
+			const uchar*    mIndex;       // Record offsets
+			QStringList     mKeys;
+			int             mNFieldsMax;
+			int             mNRecords;
+
+			// Writing
+			QSaveFile*      mWriter;
+			QString         mWriteSource;
+			qint64          mWriteSourceSize;
+			qint64          mWriteSourceMTime;
+			QVector<qint64> mOffsets;
+			QByteArray      mRecordData;
+		};
+
+	}
+}
+
+
+#endif // merge_TextCache_h
@@ -0,0 +1,492 @@
+/*  Merge/TextParser.cpp
+ *
+ *  Copyright (C) 2016  Jim Evins <evins@snaught.com>
+ *
+ *  This file is part of gLabels-qt.
+ *
+ *  gLabels-qt is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  gLabels-qt is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with gLabels-qt.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "TextParser.h"
+
+#include <QtDebug>
+
+#include <algorithm>
+#include <climits>
+
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#define MERGE_TEXT_USE_SSE2 1
+#include <emmintrin.h>
+#if defined(_MSC_VER)
+#include <intrin.h>
+#endif
+#endif
+
+
+namespace glabels
+{
+	namespace merge
+	{
+
+		//
+		// Private
+		//
+		namespace
+		{
+			const int readBufferSize = 256 * 1024;
+
+
+			///
+			/// Count leading characters of p[0..n) that are none of c1..c4
+			///
+			int findSpecial( const char* p, int n, char c1, char c2, char c3, char c4 )
+			{
+				int i = 0;
+
+#if defined(MERGE_TEXT_USE_SSE2)
+				// Test 16 characters at a time
+				const __m128i v1 = _mm_set1_epi8( c1 );
+				const __m128i v2 = _mm_set1_epi8( c2 );
+				const __m128i v3 = _mm_set1_epi8( c3 );
+				const __m128i v4 = _mm_set1_epi8( c4 );
+
+				for ( ; i + 16 <= n; i += 16 )
+				{
+					__m128i chunk = _mm_loadu_si128( reinterpret_cast<const __m128i*>( p + i ) );
+					__m128i match = _mm_or_si128( _mm_or_si128( _mm_cmpeq_epi8( chunk, v1 ),
+					                                            _mm_cmpeq_epi8( chunk, v2 ) ),
+					                              _mm_or_si128( _mm_cmpeq_epi8( chunk, v3 ),
+					                                            _mm_cmpeq_epi8( chunk, v4 ) ) );
+					int mask = _mm_movemask_epi8( match );
+					if ( mask )
+					{
+#if defined(_MSC_VER)
+						unsigned long iBit;
+						_BitScanForward( &iBit, mask );
+						return i + int(iBit);
+#else
+						return i + __builtin_ctz( mask );
+#endif
+					}
+				}
+#endif
+
+				for ( ; i < n; i++ )
+				{
+					char c = p[i];
+					if ( (c == c1) || (c == c2) || (c == c3) || (c == c4) )
+					{
+						break;
+					}
+				}
+
+				return i;
+			}
+		}
+
+
+		///
+		/// Constructor
+		///
+		TextParser::TextParser( char delimiter )
+			: mDelimiter(delimiter), mDevice(nullptr), mData(nullptr), mBase(0), mPos(0), mEnd(0)
+		{
+		}
+
+
+		///
+		/// Parse lines read from device, starting at its current position
+		///
+		void TextParser::setDevice( QIODevice* device )
+		{
+			clear();
+			mDevice = device;
+		}
+
+
+		///
+		/// Parse lines from memory
+		///
+		/// The data is not copied, and must remain valid while being parsed.
+		///
+		void TextParser::setData( const char* data, qint64 size )
+		{
+			clear();
+			mData = data;
+			mEnd  = size;
+		}
+
+
+		///
+		/// Forget device or data
+		///
+		void TextParser::clear()
+		{
+			mDevice = nullptr;
+			mBuffer.clear();
+
+			mData = nullptr;
+			mBase = 0;
+			mPos  = 0;
+			mEnd  = 0;
+		}
+
+
+		///
+		/// Only decode fields whose mask entry is true
+		///
+		/// Other fields, including any beyond the end of the mask, are returned as
+		/// null strings.  An empty mask decodes all fields.
+		///
+		void TextParser::setFieldMask( const QVector<bool>& mask )
+		{
+			mFieldMask = mask;
+		}
+
+
+		///
+		/// Offset of next character to be parsed, within the device or data
+		///
+		qint64 TextParser::offset() const
+		{
+			return mBase + mPos;
+		}
+
+
+		///
+		/// Parse line.                                                     
+		///                                                                           
+		/// Attempt to be a robust parser of various CSV (and similar) formats.       
+		///                                                                           
+		/// Based on CSV format described in RFC 4180 section 2.                      
+		///                                                                           
+		/// Additions to RFC 4180 rules:                                              
+		///   - delimeters and other special characters may be "escaped" by a leading 
+		///     backslash (\)                                                         
+		///   - C escape sequences for newline (\n) and tab (\t) are also translated. 
+		///   - if quoted text is not followed by a delimeter, any additional text is 
+		///     concatenated with quoted portion.                                     
+		///                                                                           
+		/// Returns a list of fields.  A blank line is considered a line with one     
+		/// empty field.  Returns an empty list when done.                             
+		///
+		/// Runs of ordinary characters within a field are copied from the data in
+		/// one go, unless the field is masked out.  CR characters are ignored wherever they occur, as they would be
+		/// if read in text mode.
+		///
+		QStringList TextParser::parseLine()
+		{
+			QStringList fields;
+	
+			enum State
+			{
+				DELIM, QUOTED, QUOTED_QUOTE1, QUOTED_ESCAPED, SIMPLE, SIMPLE_ESCAPED, DONE
+			} state = DELIM;
+
+			QByteArray field;
+
+			char delim = mDelimiter;
+	
+			while ( state != DONE )
+			{
+				if ( (mPos < mEnd) || fill() )
+				{
+					const char* p = mData + mPos;
+					int         n = int( std::min( mEnd - mPos, qint64(INT_MAX) ) );
+
+					/* Copy any run of ordinary characters in one go. */
+					int nRun = 0;
+					if ( state == SIMPLE )
+					{
+						nRun = findSpecial( p, n, delim, '\n', '\\', '\r' );
+					}
+					else if ( state == QUOTED )
+					{
+						nRun = findSpecial( p, n, '"', '\\', '\r', '\r' );
+					}
+					if ( nRun > 0 )
+					{
+						if ( isFieldDecoded( fields.size() ) )
+						{
+							field.append( p, nRun );
+						}
+						mPos += nRun;
+						continue;
+					}
+
+					char c = *p;
+					mPos++;
+
+					if ( c == '\r' )
+					{
+						/* CRs are ignored everywhere, as if read in text mode. */
+						continue;
+					}
+
+					switch (state)
+					{
+
+					case DELIM:
+						switch (c)
+						{
+						case '\n':
+							/* last field is empty. */
+							fields << "";
+							state = DONE;
+							break;
+						case '"':
+							/* start a quoted field. */
+							state = QUOTED;
+							break;
+						case '\\':
+							/* simple field, but 1st character is an escape. */
+							state = SIMPLE_ESCAPED;
+							break;
+						default:
+							if ( c == delim )
+							{
+								/* field is empty. */
+								fields << "";
+								state = DELIM;
+							}
+							else
+							{
+								/* beginning of a simple field. */
+								field.append( c );
+								state = SIMPLE;
+							}
+							break;
+						}
+						break;
+
+					case QUOTED:
+						switch (c)
+						{
+						case '"':
+							/* Possible end of field, but could be 1st of a pair. */
+							state = QUOTED_QUOTE1;
+							break;
+						case '\\':
+							/* Escape next character, or special escape, e.g. \n. */
+							state = QUOTED_ESCAPED;
+							break;
+						default:
+							/* Use character literally. */
+							field.append( c );
+							break;
+						}
+						break;
+
+					case QUOTED_QUOTE1:
+						switch (c)
+						{
+						case '\n':
+							/* line ended after quoted item */
+							fields << decodeField( fields.size(), field );
+							state = DONE;
+							break;
+						case '"':
+							/* second quote, insert and stay quoted. */
+							field.append( c );
+							state = QUOTED;
+							break;
+						default:
+							if ( c == delim )
+							{
+								/* end of field. */
+								fields << decodeField( fields.size(), field );
+								field.clear();
+								state = DELIM;
+							}
+							else
+							{
+								/* fallback if not a delim or another quote. */
+								field.append( c );
+								state = SIMPLE;
+							}
+							break;
+						}
+						break;
+
+					case QUOTED_ESCAPED:
+						switch (c)
+						{
+						case 'n':
+							/* Decode "\n" as newline. */
+							field.append( '\n' );
+							state = QUOTED;
+							break;
+						case 't':
+							/* Decode "\t" as tab. */
+							field.append( '\t' );
+							state = QUOTED;
+							break;
+						default:
+							/* Use character literally. */
+							field.append( c );
+							state = QUOTED;
+							break;
+						}
+						break;
+
+					case SIMPLE:
+						switch (c)
+						{
+						case '\n':
+							/* line ended */
+							fields << decodeField( fields.size(), field );
+							state = DONE;
+							break;
+						case '\\':
+							/* Escape next character, or special escape, e.g. \n. */
+							state = SIMPLE_ESCAPED;
+							break;
+						default:
+							if ( c == delim )
+							{
+								/* end of field. */
+								fields << decodeField( fields.size(), field );
+								field.clear();
+								state = DELIM;
+							}
+							else
+							{
+								/* Use character literally. */
+								field.append( c );
+								state = SIMPLE;
+							}
+							break;
+						}
+						break;
+
+					case SIMPLE_ESCAPED:
+						switch (c)
+						{
+						case 'n':
+							/* Decode "\n" as newline. */
+							field.append( '\n' );
+							state = SIMPLE;
+							break;
+						case 't':
+							/* Decode "\t" as tab. */
+							field.append( '\t' );
+							state = SIMPLE;
+							break;
+						default:
+							/* Use character literally. */
+							field.append( c );
+							state = SIMPLE;
+							break;
+						}
+						break;
+
+					default:
+						qWarning( "merge::Text::parseLine()::Should not be reached! #1" );
+						break;
+					}
+
+				}
+				else
+				{
+					/* Handle EOF (could also be an error while reading). */
+					switch (state)
+					{
+
+					case DELIM:
+						/* EOF, no more lines. */
+						break;
+
+					case QUOTED:
+						/* File ended midway through quoted item. Truncate field. */
+						fields << decodeField( fields.size(), field );
+						break;
+
+					case QUOTED_QUOTE1:
+						/* File ended after quoted item. */
+						fields << decodeField( fields.size(), field );
+						break;
+
+					case QUOTED_ESCAPED:
+						/* File ended midway through quoted item. Truncate field. */
+						fields << decodeField( fields.size(), field );
+						break;
+
+					case SIMPLE:
+						/* File ended after simple item. */
+						fields << decodeField( fields.size(), field );
+						break;
+
+					case SIMPLE_ESCAPED:
+						/* File ended midway through escaped item. */
+						fields << decodeField( fields.size(), field );
+						break;
+
+					default:
+						qWarning( "merge::Text::parseLine()::Should not be reached! #2" );
+						break;
+					}
+			
+					state = DONE;
+				}
+			}
+	
+
+			return fields;
+		}
+
+
+		///
+		/// Refill read buffer from device
+		///
+		/// Returns false at end of data.
+		///
+		bool TextParser::fill()
+		{
+			if ( !mDevice )
+			{
+				return false;
+			}
+
+			mBase += mEnd;
+			mPos   = 0;
+			mEnd   = 0;
+
+			mBuffer.resize( readBufferSize );
+			qint64 nRead = mDevice->read( mBuffer.data(), readBufferSize );
+			mData = mBuffer.constData();
+			mEnd  = (nRead > 0) ? nRead : 0;
+
+			return mEnd > 0;
+		}
+
+
+		///
+		/// Is i'th field of line decoded?
+		///
+		bool TextParser::isFieldDecoded( int iField ) const
+		{
+			return mFieldMask.isEmpty() || ( (iField < mFieldMask.size()) && mFieldMask[iField] );
+		}
+
+
+		///
+		/// Decode i'th field of line, if not masked out
+		///
+		QString TextParser::decodeField( int iField, const QByteArray& field ) const
+		{
+			return isFieldDecoded( iField ) ? QString::fromUtf8( field ) : QString();
+		}
+
+	} // namespace merge
+} // namespace glabels
@@ -0,0 +1,94 @@
+/*  Merge/TextParser.h
+ *
+ *  Copyright (C) 2016  Jim Evins <evins@snaught.com>
+ *
+ *  This file is part of gLabels-qt.
+ *
+ *  gLabels-qt is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  gLabels-qt is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with gLabels-qt.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef merge_TextParser_h
+#define merge_TextParser_h
+
+
+#include <QByteArray>
+#include <QIODevice>
+#include <QStringList>
+#include <QVector>
+
+
+namespace glabels
+{
+	namespace merge
+	{
+
+		///
+		/// Delimited Text Parser
+		///
+		/// Parses lines of delimited text, either read a block at a time from a
+		/// device, or directly from a range of memory.
+		///
+		class TextParser
+		{
+
+			/////////////////////////////////
+			// Life Cycle
+			/////////////////////////////////
+		public:
+			TextParser( char delimiter );
+
+
+			/////////////////////////////////
+			// Public methods
+			/////////////////////////////////
+		public:
+			void setDevice( QIODevice* device );
+			void setData( const char* data, qint64 size );
+			void clear();
+			void setFieldMask( const QVector<bool>& mask );
+
+			qint64 offset() const;
+			QStringList parseLine();
+
+
+			/////////////////////////////////
+			// Private methods
+			/////////////////////////////////
+		private:
+			bool fill();
+			bool isFieldDecoded( int iField ) const;
+			QString decodeField( int iField, const QByteArray& field ) const;
+
+
+			/////////////////////////////////
+			// Private data
+			/////////////////////////////////
+		private:
+			char          mDelimiter;
+			QVector<bool> mFieldMask;
+
+			QIODevice*    mDevice;
+			QByteArray    mBuffer;
+
+			const char*   mData;    // Data being parsed
+			qint64        mBase;    // Offset of data within device
+			qint64        mPos;     // Position of next character within data
+			qint64        mEnd;     // End of data
+		};
+
+	}
+}
+
+
+#endif // merge_TextParser_h
@@ -28,14 +28,18 @@
 
 #include "barcode/Backends.h"
 #include "merge/Factory.h"
+#include "merge/Text.h"
 
 #include <QApplication>
 #include <QCommandLineParser>
 #include <QDebug>
+#include <QFileInfo>
+#include <QImageWriter>
 #include <QLibraryInfo>
 #include <QLocale>
 #include <QPrinter>
 #include <QPrinterInfo>
+#include <QThread>
 #include <QTranslator>
 
 
@@ -53,6 +57,31 @@ namespace
 	const QString STDIN_FILENAME  = "/dev/stdin";
 #endif
 
+
+	void setupPrinter( QPrinter& printer, const QCommandLineParser& parser )
+	{
+		printer.setColorMode( QPrinter::Color );
+		if ( parser.isSet("printer") )
+		{
+			qDebug() << "Printer =" << parser.value("printer");
+			printer.setPrinterName( parser.value("printer") );
+		}
+		else if ( parser.isSet("output") )
+		{
+			QString outputFilename = parser.value("output");
+			if ( outputFilename == "-" )
+			{
+				outputFilename = STDOUT_FILENAME;
+			}
+			qDebug() << "Output =" << outputFilename;
+			printer.setOutputFileName( outputFilename );
+		}
+		else
+		{
+			qDebug() << "Batch mode.  printer =" << QPrinterInfo::defaultPrinterName();
+		}
+	}
+
 }
 
 
@@ -132,6 +161,36 @@ int main( int argc, char **argv )
 		{{"r","reverse"},
 		 QCoreApplication::translate( "main", "Print in reverse (mirror image)." ) },
 
+		{{"j","jobs"},
+		 QCoreApplication::translate( "main", "Render pages using <n> parallel jobs. Set to 0 for one job per CPU core. (Default=1)" ),
+		 "n", "1" },
+
+		{{"format"},
+		 QCoreApplication::translate( "main", "Set output format to <format>: pdf, png, tiff, pbm or pic. (Default=pdf)" ),
+		 QCoreApplication::translate( "main", "format" ),
+		 "pdf" },
+
+		{{"dpi"},
+		 QCoreApplication::translate( "main", "Set resolution of image output formats to <n> dots per inch. (Default=300)" ),
+		 "n", "300" },
+
+		{{"per-label"},
+		 QCoreApplication::translate( "main", "Write one image per label, instead of one per page." ) },
+
+		{{"shard"},
+		 QCoreApplication::translate( "main", "Render only shard <i> of <n>: the i'th of n equal ranges of pages." ),
+		 "i/n" },
+
+		{{"pages"},
+		 QCoreApplication::translate( "main", "Render only pages <a> through <b>." ),
+		 "a-b" },
+
+		{{"merge-cache"},
+		 QCoreApplication::translate( "main", "Cache parsed merge sources in files beside them, for faster reuse." ) },
+
+		{{"concat"},
+		 QCoreApplication::translate( "main", "Combine pic files, given in place of the project file, into one output in page order." ) },
+
 		{{"D","define"},
 		 QCoreApplication::translate( "main", "Set user variable <var> to <value>" ),
 		 QCoreApplication::translate( "main", "var>=<value" ) }
@@ -144,7 +203,7 @@ int main( int argc, char **argv )
 	parser.addHelpOption();
 	parser.addVersionOption();
 	parser.addPositionalArgument( "file",
-	                              QCoreApplication::translate( "main", "gLabels project file to print." ),
+	                              QCoreApplication::translate( "main", "gLabels project file to print, or pic files to combine with --concat." ),
 	                              "file" );
 	parser.process( app );
 
@@ -173,8 +232,28 @@ int main( int argc, char **argv )
 	glabels::merge::Factory::init();
 	glabels::barcode::Backends::init();
 
+	glabels::merge::Text::setCacheEnabled( parser.isSet( "merge-cache" ) );
+
 	
-	if ( parser.positionalArguments().size() == 1 )
+	if ( parser.isSet( "concat" ) )
+	{
+		qDebug() << "Concatenate mode.";
+
+		if ( parser.positionalArguments().isEmpty() )
+		{
+			qWarning() << "Error: missing picture files.";
+			return -1;
+		}
+
+		QPrinter printer( QPrinter::HighResolution );
+		setupPrinter( printer, parser );
+
+		if ( !glabels::model::PageRenderer::printPictureFiles( &printer, parser.positionalArguments() ) )
+		{
+			return -1;
+		}
+	}
+	else if ( parser.positionalArguments().size() == 1 )
 	{
 		qDebug() << "Batch mode.";
 
@@ -191,26 +270,7 @@ int main( int argc, char **argv )
 			model->variables()->setVariables( variableDefinitions );
 
 			QPrinter printer( QPrinter::HighResolution );
-			printer.setColorMode( QPrinter::Color );
-			if ( parser.isSet("printer") )
-			{
-				qDebug() << "Printer =" << parser.value("printer");
-				printer.setPrinterName( parser.value("printer") );
-			}
-			else if ( parser.isSet("output") )
-			{
-				QString outputFilename = parser.value("output");
-				if ( outputFilename == "-" )
-				{
-					outputFilename = STDOUT_FILENAME;
-				}
-				qDebug() << "Output =" << outputFilename;
-				printer.setOutputFileName( outputFilename );
-			}
-			else
-			{
-				qDebug() << "Batch mode.  printer =" << QPrinterInfo::defaultPrinterName();
-			}
+			setupPrinter( printer, parser );
 
 			glabels::model::PageRenderer renderer( model );
 			if ( model->merge()->keys().empty() )
@@ -237,7 +297,9 @@ int main( int argc, char **argv )
 			}
 			else
 			{
-				// Project with merge
+				// Project with merge, only storing the fields that it references
+				model->merge()->setFieldFilter( model->fieldNames() );
+
 				renderer.setNCopies( parser.value( "copies" ).toInt() );
 				renderer.setStartItem( parser.value( "first" ).toInt() - 1 );
 				renderer.setIsCollated( parser.isSet( "collate" ) );
@@ -264,8 +326,110 @@ int main( int argc, char **argv )
 				qDebug() << "Printing" << renderer.nItems() << "items on" << renderer.nPages() << "pages.";
 			}
 
+			// Range of pages to render
+			if ( parser.isSet( "shard" ) )
+			{
+				QStringList parts = parser.value( "shard" ).split( '/' );
+				int iShard = (parts.size() == 2) ? parts[0].toInt() : 0;
+				int nShards = (parts.size() == 2) ? parts[1].toInt() : 0;
+				if ( (nShards < 1) || (iShard < 1) || (iShard > nShards) )
+				{
+					qWarning() << "Error: bad shard:" << parser.value( "shard" );
+					return -1;
+				}
+
+				int iFirstPage = (iShard-1) * renderer.nPages() / nShards;
+				int iEndPage   = iShard * renderer.nPages() / nShards;
+				renderer.setPrintRange( iFirstPage, iEndPage - iFirstPage );
+				qDebug() << "Shard" << iShard << "of" << nShards << ": pages" << iFirstPage+1 << "to" << iEndPage;
+			}
+			else if ( parser.isSet( "pages" ) )
+			{
+				QStringList parts = parser.value( "pages" ).split( '-' );
+				int iFirst = parts[0].toInt();
+				int iLast  = (parts.size() == 2) ? parts[1].toInt() : iFirst;
+				if ( (parts.size() > 2) || (iFirst < 1) || (iLast < iFirst) )
+				{
+					qWarning() << "Error: bad page range:" << parser.value( "pages" );
+					return -1;
+				}
+
+				renderer.setPrintRange( iFirst - 1, iLast - iFirst + 1 );
+				qDebug() << "Pages" << iFirst << "to" << iLast;
+			}
+
+			// Number of parallel rendering jobs
+			int nJobs = parser.value( "jobs" ).toInt();
+			if ( nJobs <= 0 )
+			{
+				nJobs = QThread::idealThreadCount();
+			}
+			if ( nJobs > 1 )
+			{
+				qDebug() << "Rendering with" << nJobs << "jobs.";
+			}
+
 			// Do it!
-			renderer.print( &printer );
+			QByteArray format = parser.value( "format" ).toLower().toLatin1();
+			if ( format == "pdf" )
+			{
+				renderer.print( &printer, nJobs );
+			}
+			else if ( format == "pic" )
+			{
+				QString outputFilename = parser.value( "output" );
+				if ( outputFilename == "-" )
+				{
+					outputFilename = STDOUT_FILENAME;
+				}
+				qDebug() << "Output =" << outputFilename;
+
+				if ( !renderer.printPictures( outputFilename, nJobs ) )
+				{
+					return -1;
+				}
+			}
+			else
+			{
+				if ( (format != "png") && (format != "tiff") && (format != "pbm") )
+				{
+					qWarning() << "Error: unknown output format:" << format;
+					return -1;
+				}
+				if ( !QImageWriter::supportedImageFormats().contains( format ) )
+				{
+					qWarning() << "Error: output format not supported by this installation:" << format;
+					return -1;
+				}
+
+				double dpi = parser.value( "dpi" ).toDouble();
+				if ( dpi <= 0 )
+				{
+					qWarning() << "Error: bad resolution:" << parser.value( "dpi" );
+					return -1;
+				}
+
+				// One file per image, numbered by replacing "%1" in the output filename,
+				// or else by appending a number to its base name
+				QString outputTemplate = parser.value( "output" );
+				if ( outputTemplate == "-" )
+				{
+					qWarning() << "Error: image output cannot be written to stdout.";
+					return -1;
+				}
+				if ( !outputTemplate.contains( "%1" ) )
+				{
+					QFileInfo fileInfo( outputTemplate );
+					outputTemplate = fileInfo.path() + "/" + fileInfo.completeBaseName() + "-%1." + format;
+				}
+				qDebug() << "Output =" << outputTemplate;
+
+				bool perLabel = parser.isSet( "per-label" );
+				if ( !renderer.printImages( outputTemplate, format, dpi, perLabel, nJobs ) )
+				{
+					return -1;
+				}
+			}
 		}
 	}
 	else
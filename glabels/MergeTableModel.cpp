@@ -0,0 +1,311 @@
+/*  MergeTableModel.cpp
+ *
+ *  Copyright (C) 2016  Jim Evins <evins@snaught.com>
+ *
+ *  This file is part of gLabels-qt.
+ *
+ *  gLabels-qt is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  gLabels-qt is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with gLabels-qt.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "MergeTableModel.h"
+
+#include "merge/Record.h"
+
+#include <QtDebug>
+
+#include <algorithm>
+
+
+namespace glabels
+{
+
+	//
+	// Private
+	//
+	namespace
+	{
+		const int rowsPerBlock = 100;
+		const int maxBlocks    = 50;
+	}
+
+
+	///
+	/// Constructor
+	///
+	MergeTableModel::MergeTableModel( QObject* parent )
+		: QAbstractTableModel(parent), mNRows(0), mBlocks(maxBlocks)
+	{
+		// empty
+	}
+
+
+	///
+	/// Set merge object
+	///
+	void MergeTableModel::setMerge( merge::Merge* merge )
+	{
+		beginResetModel();
+
+		if ( mMerge )
+		{
+			disconnect( mMerge, nullptr, this, nullptr );
+		}
+
+		mMerge = merge;
+		loadKeys();
+
+		if ( mMerge )
+		{
+			connect( mMerge, SIGNAL(sourceChanged()), this, SLOT(onMergeSourceChanged()) );
+			connect( mMerge, SIGNAL(selectionChanged()), this, SLOT(onMergeSelectionChanged()) );
+		}
+
+		endResetModel();
+	}
+
+
+	///
+	/// Number of rows (records)
+	///
+	int MergeTableModel::rowCount( const QModelIndex& parent ) const
+	{
+		return parent.isValid() ? 0 : mNRows;
+	}
+
+
+	///
+	/// Number of columns (keys)
+	///
+	int MergeTableModel::columnCount( const QModelIndex& parent ) const
+	{
+		return parent.isValid() ? 0 : mKeys.size();
+	}
+
+
+	///
+	/// Get cell data
+	///
+	QVariant MergeTableModel::data( const QModelIndex& index, int role ) const
+	{
+		if ( !mMerge || !index.isValid() || (index.row() >= mNRows) )
+		{
+			return QVariant();
+		}
+
+		switch ( role )
+		{
+		case Qt::DisplayRole:
+			return value( index.row(), index.column() );
+
+		case Qt::CheckStateRole:
+			if ( index.column() == 0 )
+			{
+				return mMerge->isSelected( index.row() ) ? Qt::Checked : Qt::Unchecked;
+			}
+			break;
+
+		default:
+			break;
+		}
+
+		return QVariant();
+	}
+
+
+	///
+	/// Set cell data, i.e. select or unselect record
+	///
+	bool MergeTableModel::setData( const QModelIndex& index, const QVariant& value, int role )
+	{
+		if ( mMerge && index.isValid() && (index.column() == 0) && (role == Qt::CheckStateRole) )
+		{
+			mMerge->setSelected( index.row(), value.toInt() != Qt::Unchecked );
+			return true;
+		}
+
+		return false;
+	}
+
+
+	///
+	/// Get cell flags
+	///
+	Qt::ItemFlags MergeTableModel::flags( const QModelIndex& index ) const
+	{
+		if ( !index.isValid() )
+		{
+			return Qt::NoItemFlags;
+		}
+
+		if ( index.column() == 0 )
+		{
+			return Qt::ItemIsEnabled | Qt::ItemIsUserCheckable;
+		}
+
+		return Qt::ItemIsEnabled;
+	}
+
+
+	///
+	/// Get header data
+	///
+	QVariant MergeTableModel::headerData( int section, Qt::Orientation orientation, int role ) const
+	{
+		if ( role != Qt::DisplayRole )
+		{
+			return QVariant();
+		}
+
+		if ( orientation == Qt::Vertical )
+		{
+			return section + 1;
+		}
+
+		if ( (section >= 0) && (section < mKeys.size()) )
+		{
+			return mKeys[section];
+		}
+
+		return QVariant();
+	}
+
+
+	///
+	/// Merge source changed handler
+	///
+	void MergeTableModel::onMergeSourceChanged()
+	{
+		beginResetModel();
+		loadKeys();
+		endResetModel();
+	}
+
+
+	///
+	/// Merge selection changed handler
+	///
+	void MergeTableModel::onMergeSelectionChanged()
+	{
+		if ( mMerge && mMerge->isLoaded() )
+		{
+			// Records now read from merge object
+			mCursor.setMerge( nullptr );
+			mBlocks.clear();
+		}
+
+		if ( mNRows > 0 )
+		{
+			emit dataChanged( index( 0, 0 ), index( mNRows - 1, 0 ), QVector<int>() << Qt::CheckStateRole );
+		}
+	}
+
+
+	///
+	/// Load keys and row count of merge object
+	///
+	/// Records are not loaded into memory, unless already loaded.
+	///
+	void MergeTableModel::loadKeys()
+	{
+		mKeys.clear();
+		mNRows = 0;
+		mCursor.setMerge( nullptr );
+		mBlocks.clear();
+
+		if ( mMerge )
+		{
+			QString primaryKey = mMerge->primaryKey();
+			QStringList keys   = mMerge->keys();
+
+			if ( !keys.isEmpty() )
+			{
+				mKeys << primaryKey;
+				foreach ( QString key, keys )
+				{
+					if ( key != primaryKey )
+					{
+						mKeys << key;
+					}
+				}
+
+				mNRows = mMerge->nRecords();
+			}
+
+			if ( !mMerge->isLoaded() )
+			{
+				// All records selected, so cursor reads every record
+				mCursor.setMerge( mMerge.data() );
+			}
+		}
+	}
+
+
+	///
+	/// Get value of cell
+	///
+	QString MergeTableModel::value( int row, int column ) const
+	{
+		if ( mMerge->isLoaded() )
+		{
+			return mMerge->recordList()[row]->value( mKeys[column] );
+		}
+
+		int iBlock = row / rowsPerBlock;
+		QVector<QStringList>* block = mBlocks.object( iBlock );
+		if ( !block )
+		{
+			block = readBlock( iBlock );
+			mBlocks.insert( iBlock, block );
+		}
+
+		int iRow = row % rowsPerBlock;
+		return (iRow < block->size()) ? block->at( iRow ).value( column ) : QString();
+	}
+
+
+	///
+	/// Read block of rows from merge source
+	///
+	/// The cursor reads forward cheaply, so reading the blocks in view in order
+	/// reads the source once.
+	///
+	QVector<QStringList>* MergeTableModel::readBlock( int iBlock ) const
+	{
+		int firstRow = iBlock * rowsPerBlock;
+		int lastRow  = std::min( firstRow + rowsPerBlock, mNRows );
+
+		auto* block = new QVector<QStringList>;
+		block->reserve( lastRow - firstRow );
+
+		for ( int row = firstRow; row < lastRow; row++ )
+		{
+			merge::Record* record = mCursor.at( row );
+			if ( !record )
+			{
+				// Source is shorter than when scanned
+				break;
+			}
+
+			QStringList values;
+			foreach ( QString key, mKeys )
+			{
+				values << record->value( key );
+			}
+			*block << values;
+		}
+
+		return block;
+	}
+
+}
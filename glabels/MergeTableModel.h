@@ -0,0 +1,114 @@
+/*  MergeTableModel.h
+ *
+ *  Copyright (C) 2016  Jim Evins <evins@snaught.com>
+ *
+ *  This file is part of gLabels-qt.
+ *
+ *  gLabels-qt is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  gLabels-qt is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with gLabels-qt.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef MergeTableModel_h
+#define MergeTableModel_h
+
+
+#include "merge/Merge.h"
+#include "merge/RecordCursor.h"
+
+#include <QAbstractTableModel>
+#include <QCache>
+#include <QPointer>
+#include <QStringList>
+#include <QVector>
+
+
+namespace glabels
+{
+
+	///
+	/// Merge Table Model
+	///
+	/// Presents the records of a merge object as a table, one row per record,
+	/// with the primary key in the first column, followed by the other keys.
+	/// Cells are read from the records only when needed by the view.  Until the
+	/// records are loaded, which happens when first changing the selection,
+	/// cells are read from the merge source a block of rows at a time, keeping
+	/// only recently viewed blocks in memory.  The first column is checkable,
+	/// and reflects the selection of records.
+	///
+	class MergeTableModel : public QAbstractTableModel
+	{
+		Q_OBJECT
+
+
+		/////////////////////////////////
+		// Life Cycle
+		/////////////////////////////////
+	public:
+		MergeTableModel( QObject* parent = nullptr );
+
+
+		/////////////////////////////////
+		// Public methods
+		/////////////////////////////////
+	public:
+		void setMerge( merge::Merge* merge );
+
+
+		/////////////////////////////////
+		// Implementation of QAbstractTableModel
+		/////////////////////////////////
+	public:
+		int rowCount( const QModelIndex& parent = QModelIndex() ) const override;
+		int columnCount( const QModelIndex& parent = QModelIndex() ) const override;
+		QVariant data( const QModelIndex& index, int role = Qt::DisplayRole ) const override;
+		bool setData( const QModelIndex& index, const QVariant& value, int role = Qt::EditRole ) override;
+		Qt::ItemFlags flags( const QModelIndex& index ) const override;
+		QVariant headerData( int section, Qt::Orientation orientation, int role = Qt::DisplayRole ) const override;
+
+
+		/////////////////////////////////
+		// Slots
+		/////////////////////////////////
+	private slots:
+		void onMergeSourceChanged();
+		void onMergeSelectionChanged();
+
+
+		/////////////////////////////////
+		// Private methods
+		/////////////////////////////////
+	private:
+		void loadKeys();
+		QString value( int row, int column ) const;
+		QVector<QStringList>* readBlock( int iBlock ) const;
+
+
+		/////////////////////////////////
+		// Private Data
+		/////////////////////////////////
+	private:
+		QPointer<merge::Merge>                      mMerge;
+
+		QStringList                                 mKeys;    // Primary key first
+		int                                         mNRows;
+
+		mutable merge::RecordCursor                 mCursor;  // Reads source, until loaded
+		mutable QCache< int, QVector<QStringList> > mBlocks;  // Recently read blocks of rows
+
+	};
+
+}
+
+
+#endif // MergeTableModel_h
@@ -26,6 +26,7 @@
 
 #include <QFileDialog>
 #include <QFileInfo>
+#include <QHeaderView>
 #include <QtDebug>
 
 
@@ -36,14 +37,20 @@ namespace glabels
 	/// Constructor
 	///
 	MergeView::MergeView( QWidget *parent )
-		: QWidget(parent), mModel(nullptr), mUndoRedoModel(nullptr), mBlock(false), mOldFormatComboIndex(0)
+		: QWidget(parent), mModel(nullptr), mUndoRedoModel(nullptr), mOldFormatComboIndex(0)
 	{
 		setupUi( this );
 
+		mTableModel = new MergeTableModel( this );
+		recordsTable->setModel( mTableModel );
+		recordsTable->horizontalHeader()->setStretchLastSection( true );
+
 		titleLabel->setText( QString( "<span style='font-size:18pt;'>%1</span>" ).arg( tr("Merge") ) );
 
 		mMergeFormatNames = merge::Factory::nameList();
 		formatCombo->addItems( mMergeFormatNames );
+
+		showLoading( false );
 	}
 
 
@@ -105,19 +112,17 @@ namespace glabels
 			break;
 		}
 
-		recordsTable->clear();
-		recordsTable->setColumnCount( 0 );
-		loadHeaders( mModel->merge() );
-		loadTable( mModel->merge() );
+		mTableModel->setMerge( mModel->merge() );
+		recordsTable->resizeColumnsToContents();
+
+		showLoading( mModel->merge()->isLoading() );
 
 		connect( mModel->merge(), SIGNAL(sourceChanged()),
 		         this, SLOT(onMergeSourceChanged()) );
-		
-		connect( mModel->merge(), SIGNAL(selectionChanged()),
-		         this, SLOT(onMergeSelectionChanged()) );
-
-		connect( recordsTable, SIGNAL(cellChanged(int,int)),
-		         this, SLOT(onCellChanged(int,int)) );
+		connect( mModel->merge(), SIGNAL(loadProgress(int,int)),
+		         this, SLOT(onMergeLoadProgress(int,int)) );
+		connect( mModel->merge(), SIGNAL(loadFinished()),
+		         this, SLOT(onMergeLoadFinished()) );
 	}
 
 
@@ -129,32 +134,35 @@ namespace glabels
 		QString fn = model::FileUtil::makeRelativeIfInDir( mModel->dir(), mModel->merge()->source() );
 		locationLineEdit->setText( fn );
 
-		recordsTable->clear();
-		recordsTable->setColumnCount( 0 );
-		loadHeaders( mModel->merge() );
-		loadTable( mModel->merge() );
+		recordsTable->resizeColumnsToContents();
 	}
 
 
 	///
-	/// Merge selection changed handler
+	/// Merge load progress handler
 	///
-	void MergeView::onMergeSelectionChanged()
+	void MergeView::onMergeLoadProgress( int nRecords, int percent )
 	{
-		mBlock = true;  // Don't recurse
-	
-		const QList<merge::Record*>& records = mModel->merge()->recordList();
-
-		int iRow = 0;
-		foreach ( merge::Record* record, records )
+		if ( percent < 0 )
 		{
-			QTableWidgetItem* item = recordsTable->item( iRow, 0 );
-			item->setCheckState( record->isSelected() ? Qt::Checked : Qt::Unchecked );
-
-			iRow++;
+			// Size unknown, just show activity
+			loadProgressBar->setRange( 0, 0 );
+		}
+		else
+		{
+			loadProgressBar->setRange( 0, 100 );
+			loadProgressBar->setValue( percent );
 		}
+		loadProgressBar->setToolTip( tr("%1 records read").arg( nRecords ) );
+	}
+
 
-		mBlock = false;
+	///
+	/// Merge load finished handler
+	///
+	void MergeView::onMergeLoadFinished()
+	{
+		showLoading( false );
 	}
 
 
@@ -186,137 +194,53 @@ namespace glabels
 			                              tr("All files (*)") );
 		if ( !fileName.isEmpty() )
 		{
-			mModel->merge()->setSource( fileName );
+			// Load in background, the source is changed once loaded
+			mModel->merge()->loadSource( fileName );
+			showLoading( true );
 			mCwd = QFileInfo( fileName ).absolutePath(); // Update CWD
 		}
 	}
 
 
 	///
-	/// Select all button clicked handler
+	/// Load cancel button clicked handler
 	///
-	void MergeView::onSelectAllButtonClicked()
+	void MergeView::onLoadCancelButtonClicked()
 	{
-		mModel->merge()->selectAll();
+		mModel->merge()->cancelLoad();
 	}
 
 
 	///
-	/// Unselect all button clicked handler
-	///
-	void MergeView::onUnselectAllButtonClicked()
-	{
-		mModel->merge()->unselectAll();
-	}
-
-
-	///
-	/// Cell changed handler
+	/// Select all button clicked handler
 	///
-	void MergeView::onCellChanged( int iRow, int iCol )
+	void MergeView::onSelectAllButtonClicked()
 	{
-		if ( !mBlock )
-		{
-			QTableWidgetItem* item = recordsTable->item( iRow, 0 );
-			bool state = (item->checkState() == Qt::Unchecked) ? false : true;
-		
-			mModel->merge()->setSelected( iRow, state );
-		}
+		mModel->merge()->selectAll();
 	}
 
 
 	///
-	/// Load headers
+	/// Unselect all button clicked handler
 	///
-	void MergeView::loadHeaders( merge::Merge* merge )
+	void MergeView::onUnselectAllButtonClicked()
 	{
-		mPrimaryKey = merge->primaryKey();
-		mKeys = merge->keys();
-
-		if ( mKeys.size() > 0 )
-		{
-			recordsTable->setColumnCount( mKeys.size() + 1 );  // Include extra column
-
-			// First column = primary Key
-			auto* item = new QTableWidgetItem( mPrimaryKey );
-			item->setFlags( Qt::ItemIsEnabled );
-			recordsTable->setHorizontalHeaderItem( 0, item );
-
-			// Starting on second column, one column per key, skip primary Key
-			int iCol = 1;
-			foreach ( QString key, mKeys )
-			{
-				if ( key != mPrimaryKey )
-				{
-					auto* item = new QTableWidgetItem( key );
-					item->setFlags( Qt::ItemIsEnabled );
-					recordsTable->setHorizontalHeaderItem( iCol, item );
-
-					iCol++;
-				}
-
-			}
-
-			// Extra dummy column to fill any extra horizontal space
-			auto* fillItem = new QTableWidgetItem();
-			fillItem->setFlags( Qt::NoItemFlags );
-			recordsTable->setHorizontalHeaderItem( iCol, fillItem );
-			recordsTable->horizontalHeader()->setStretchLastSection( true );
-		}
+		mModel->merge()->unselectAll();
 	}
 
 
 	///
-	/// Load table
+	/// Show or hide progress of loading merge source
 	///
-	void MergeView::loadTable( merge::Merge* merge )
+	void MergeView::showLoading( bool loading )
 	{
-		mBlock = true;
-
-		const QList<merge::Record*>& records = merge->recordList();
-		recordsTable->setRowCount( records.size() );
-
-		int iRow = 0;
-		foreach ( merge::Record* record, records )
+		if ( loading )
 		{
-			// First column for primary field
-			auto* item = new QTableWidgetItem();
-			if ( record->contains( mPrimaryKey ) )
-			{
-				item->setText( (*record)[mPrimaryKey] );
-			}
-			item->setFlags( Qt::ItemIsEnabled | Qt::ItemIsUserCheckable );
-			item->setCheckState( record->isSelected() ? Qt::Checked : Qt::Unchecked );
-			recordsTable->setItem( iRow, 0, item );
-			recordsTable->resizeColumnToContents( 0 );
-
-			// Starting on 2nd column, 1 column per field, skip primary field
-			int iCol = 1;
-			foreach ( QString key, mKeys )
-			{
-				if ( key != mPrimaryKey )
-				{
-					if ( record->contains( key ) )
-					{
-						auto* item = new QTableWidgetItem( (*record)[key] );
-						item->setFlags( Qt::ItemIsEnabled );
-						recordsTable->setItem( iRow, iCol, item );
-						recordsTable->resizeColumnToContents( iCol );
-					}
-
-					iCol++;
-				}
-			}
-
-			// Extra dummy column to fill any extra horizontal space
-			auto* fillItem = new QTableWidgetItem();
-			fillItem->setFlags( Qt::NoItemFlags );
-			recordsTable->setItem( iRow, iCol, fillItem );
-
-			iRow++;
+			loadProgressBar->setRange( 0, 0 );
+			loadProgressBar->setToolTip( QString() );
 		}
-
-		mBlock = false;
+		loadProgressBar->setVisible( loading );
+		loadCancelButton->setVisible( loading );
 	}
 
 } // namespace glabels
@@ -24,6 +24,8 @@
 
 #include "ui_MergeView.h"
 
+#include "MergeTableModel.h"
+
 #include "model/Model.h"
 
 #include "merge/Merge.h"
@@ -64,21 +66,21 @@ namespace glabels
 	private slots:
 		void onMergeChanged();
 		void onMergeSourceChanged();
-		void onMergeSelectionChanged();
+		void onMergeLoadProgress( int nRecords, int percent );
+		void onMergeLoadFinished();
 
 		void onFormatComboActivated();
 		void onLocationBrowseButtonClicked();
+		void onLoadCancelButtonClicked();
 		void onSelectAllButtonClicked();
 		void onUnselectAllButtonClicked();
-		void onCellChanged( int iRow, int iCol );
 
 
 		/////////////////////////////////
 		// Private methods
 		/////////////////////////////////
 	private:
-		void loadHeaders( merge::Merge* merge );
-		void loadTable( merge::Merge* merge );
+		void showLoading( bool loading );
 
 
 		/////////////////////////////////
@@ -90,12 +92,10 @@ namespace glabels
 		model::Model*  mModel;
 		UndoRedoModel* mUndoRedoModel;
 
-		QStringList mKeys;
-		QString     mPrimaryKey;
+		MergeTableModel* mTableModel;
 
 		QString mCwd;
 
-		bool mBlock;
 		int  mOldFormatComboIndex;
 
 	};
@@ -20,8 +20,6 @@
 
 #include "Barcode.h"
 
-#include <list>
-
 #include "DrawingPrimitives.h"
 
 
@@ -42,7 +40,7 @@ namespace glbarcode
 		bool                   mIsEmpty;       /**< Empty data flag */
 		bool                   mIsDataValid;   /**< Valid data flag */
 
-		std::list<DrawingPrimitive *> mPrimitives;      /**< List of drawing primitives */
+		PrimitiveBuffer        mPrimitives;    /**< Drawing primitives */
 
 	};
 
@@ -151,44 +149,37 @@ namespace glbarcode
 
 	void Barcode::clear( )
 	{
-		std::list<DrawingPrimitive*>::iterator primitive;
-
-		for ( primitive = d->mPrimitives.begin(); primitive != d->mPrimitives.end(); primitive++ )
-		{
-			delete *primitive;
-		}
-
 		d->mPrimitives.clear();
 	}
 
 
 	void Barcode::addLine( double x, double y, double w, double h )
 	{
-		d->mPrimitives.push_back( new DrawingPrimitiveLine( x, y, w, h ) );
+		d->mPrimitives.addLine( x, y, w, h );
 	}
 
 
 	void Barcode::addBox( double x, double y, double w, double h )
 	{
-		d->mPrimitives.push_back( new DrawingPrimitiveBox( x, y, w, h ) );
+		d->mPrimitives.addBox( x, y, w, h );
 	}
 
 
 	void Barcode::addText( double x, double y, double size, const std::string& text )
 	{
-		d->mPrimitives.push_back( new DrawingPrimitiveText( x, y, size, text ) );
+		d->mPrimitives.addText( x, y, size, text );
 	}
 
 
 	void Barcode::addRing( double x, double y, double r, double w )
 	{
-		d->mPrimitives.push_back( new DrawingPrimitiveRing( x, y, r, w ) );
+		d->mPrimitives.addRing( x, y, r, w );
 	}
 
 
 	void Barcode::addHexagon( double x, double y, double h )
 	{
-		d->mPrimitives.push_back( new DrawingPrimitiveHexagon( x, y, h ) );
+		d->mPrimitives.addHexagon( x, y, h );
 	}
 
 
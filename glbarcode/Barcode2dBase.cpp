@@ -144,19 +144,72 @@ namespace glbarcode
 		double cellSize  = scale * MIN_CELL_SIZE;
 		double quietSize = scale * MIN_CELL_SIZE;
 		
-		
-		for ( int iy = 0; iy < encodedData.ny(); iy++ )
+
+		/*
+		 * Merge dark cells into rectangles: each row is split into runs of dark
+		 * cells, and a run is merged with the rectangle above it if it spans
+		 * exactly the same columns.  Rectangles never overlap.
+		 */
+		struct Span
+		{
+			int x0;   /* First column */
+			int x1;   /* Column after last */
+			int y0;   /* First row */
+		};
+		std::vector<Span> openSpans;  /* Rectangles reaching the previous row, left to right */
+		std::vector<Span> nextSpans;
+
+		for ( int iy = 0; iy <= encodedData.ny(); iy++ )
 		{
-			for ( int ix = 0; ix < encodedData.nx(); ix++ )
+			nextSpans.clear();
+			std::size_t iOpen = 0;
+
+			/* Past the last row there are no runs, which closes all rectangles. */
+			int ix = 0;
+			while ( (iy < encodedData.ny()) && (ix < encodedData.nx()) )
 			{
-				if ( encodedData[iy][ix] )
+				if ( !encodedData[iy][ix] )
+				{
+					ix++;
+					continue;
+				}
+
+				int x0 = ix;
+				while ( (ix < encodedData.nx()) && encodedData[iy][ix] )
+				{
+					ix++;
+				}
+
+				/* Close rectangles starting left of run, they cannot continue. */
+				while ( (iOpen < openSpans.size()) && (openSpans[iOpen].x0 < x0) )
 				{
-					addBox( quietSize + ix*cellSize,
-						quietSize + iy*cellSize,
-						cellSize,
-						cellSize );
+					const Span& span = openSpans[iOpen++];
+					addBox( quietSize + span.x0*cellSize,
+						quietSize + span.y0*cellSize,
+						(span.x1 - span.x0)*cellSize,
+						(iy - span.y0)*cellSize );
+				}
+
+				if ( (iOpen < openSpans.size()) && (openSpans[iOpen].x0 == x0) && (openSpans[iOpen].x1 == ix) )
+				{
+					nextSpans.push_back( openSpans[iOpen++] );
+				}
+				else
+				{
+					nextSpans.push_back( Span{ x0, ix, iy } );
 				}
 			}
+
+			for ( ; iOpen < openSpans.size(); iOpen++ )
+			{
+				const Span& span = openSpans[iOpen];
+				addBox( quietSize + span.x0*cellSize,
+					quietSize + span.y0*cellSize,
+					(span.x1 - span.x0)*cellSize,
+					(iy - span.y0)*cellSize );
+			}
+
+			openSpans.swap( nextSpans );
 		}
 
 	}
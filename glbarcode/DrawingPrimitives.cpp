@@ -130,4 +130,55 @@ namespace glbarcode
 		return mH;
 	}
 
+
+
+	void PrimitiveBuffer::clear()
+	{
+		mPrimitives.clear();
+		mTexts.clear();
+	}
+
+
+	void PrimitiveBuffer::addLine( double x, double y, double w, double h )
+	{
+		mPrimitives.push_back( { Type::LINE, -1, x, y, w, h } );
+	}
+
+
+	void PrimitiveBuffer::addBox( double x, double y, double w, double h )
+	{
+		mPrimitives.push_back( { Type::BOX, -1, x, y, w, h } );
+	}
+
+
+	void PrimitiveBuffer::addText( double x, double y, double size, const std::string& text )
+	{
+		mPrimitives.push_back( { Type::TEXT, int(mTexts.size()), x, y, size, 0 } );
+		mTexts.push_back( text );
+	}
+
+
+	void PrimitiveBuffer::addRing( double x, double y, double r, double w )
+	{
+		mPrimitives.push_back( { Type::RING, -1, x, y, r, w } );
+	}
+
+
+	void PrimitiveBuffer::addHexagon( double x, double y, double h )
+	{
+		mPrimitives.push_back( { Type::HEXAGON, -1, x, y, h, 0 } );
+	}
+
+
+	const std::vector<PrimitiveBuffer::Primitive>& PrimitiveBuffer::primitives() const
+	{
+		return mPrimitives;
+	}
+
+
+	const std::string& PrimitiveBuffer::text( const Primitive& primitive ) const
+	{
+		return mTexts[primitive.iText];
+	}
+
 }
@@ -23,6 +23,7 @@
 
 
 #include <string>
+#include <vector>
 
 
 namespace glbarcode
@@ -254,6 +255,91 @@ namespace glbarcode
 		double  mH;    /**< Height of hexagon (points). */
 	};
 
+
+
+	/**
+	 * @class PrimitiveBuffer DrawingPrimitives.h glbarcode/DrawingPrimitives.h
+	 *
+	 * A contiguous buffer of drawing primitives.
+	 *
+	 * Primitives are held by value, as records tagged with their type, rather than
+	 * as separately allocated DrawingPrimitive objects.  Building a barcode of
+	 * thousands of bars or modules therefore only grows a vector, and rendering it
+	 * dispatches on the tag.
+	 */
+	class PrimitiveBuffer
+	{
+	public:
+		/**
+		 * Type of primitive.
+		 */
+		enum class Type : unsigned char
+		{
+			LINE,     /**< See DrawingPrimitiveLine */
+			BOX,      /**< See DrawingPrimitiveBox */
+			TEXT,     /**< See DrawingPrimitiveText */
+			RING,     /**< See DrawingPrimitiveRing */
+			HEXAGON   /**< See DrawingPrimitiveHexagon */
+		};
+
+		/**
+		 * Primitive record.
+		 */
+		struct Primitive
+		{
+			Type   type;    /**< Type of primitive. */
+			int    iText;   /**< Index of text (TEXT only). */
+			double x;       /**< X coordinate of primitive's origin (points). */
+			double y;       /**< Y coordinate of primitive's origin (points). */
+			double a;       /**< Width (LINE, BOX), font size (TEXT), radius (RING) or height (HEXAGON). */
+			double b;       /**< Height (LINE, BOX) or line width (RING). */
+		};
+
+		/**
+		 * Remove all primitives, keeping storage for reuse.
+		 */
+		void clear();
+
+		/**
+		 * Add line primitive.  See DrawingPrimitiveLine.
+		 */
+		void addLine( double x, double y, double w, double h );
+
+		/**
+		 * Add box primitive.  See DrawingPrimitiveBox.
+		 */
+		void addBox( double x, double y, double w, double h );
+
+		/**
+		 * Add text primitive.  See DrawingPrimitiveText.
+		 */
+		void addText( double x, double y, double size, const std::string& text );
+
+		/**
+		 * Add ring primitive.  See DrawingPrimitiveRing.
+		 */
+		void addRing( double x, double y, double r, double w );
+
+		/**
+		 * Add hexagon primitive.  See DrawingPrimitiveHexagon.
+		 */
+		void addHexagon( double x, double y, double h );
+
+		/**
+		 * Get primitives, in order of addition.
+		 */
+		const std::vector<Primitive>& primitives() const;
+
+		/**
+		 * Get text of TEXT primitive.
+		 */
+		const std::string& text( const Primitive& primitive ) const;
+
+	private:
+		std::vector<Primitive>   mPrimitives;  /**< Primitive records. */
+		std::vector<std::string> mTexts;       /**< Texts of TEXT primitives. */
+	};
+
 }
 
 
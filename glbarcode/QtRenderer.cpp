@@ -22,14 +22,71 @@
 
 #include <QFont>
 #include <QFontMetrics>
+#include <QHash>
+#include <QPainterPath>
+#include <QStaticText>
 #include <QString>
-#include <QTextLayout>
+#include <QThreadStorage>
 #include <QtDebug>
 
 
 namespace
 {
 	const double FONT_SCALE = 0.75;
+
+	const int MAX_SHAPED_TEXTS = 256;
+
+
+	/*
+	 * Text shaped for drawing, and its offset from the text origin
+	 */
+	struct ShapedText
+	{
+		QFont       font;
+		QStaticText staticText;
+		QPointF     offset;
+	};
+
+
+	/*
+	 * Shaped texts of each thread, by size and text.  Static texts are
+	 * not shared between threads, as drawing one may update it.
+	 */
+	QThreadStorage< QHash<QString,ShapedText> > shapedTexts;
+
+
+	const ShapedText& shapedText( double size, const std::string& text )
+	{
+		QHash<QString,ShapedText>& cache = shapedTexts.localData();
+
+		QString string = QString::fromStdString( text );
+		QString key    = QString::number( size, 'g', 17 ) + ':' + string;
+
+		auto i = cache.constFind( key );
+		if ( i != cache.constEnd() )
+		{
+			return *i;
+		}
+
+		if ( cache.size() >= MAX_SHAPED_TEXTS )
+		{
+			cache.clear();
+		}
+
+		ShapedText shaped;
+		shaped.font.setStyleHint( QFont::Monospace );
+		shaped.font.setFamily( "monospace" );
+		shaped.font.setPointSizeF( FONT_SCALE*size );
+
+		QFontMetricsF fm( shaped.font );
+		shaped.offset = QPointF( -fm.width( string )/2.0, -fm.ascent() );
+
+		shaped.staticText.setText( string );
+		shaped.staticText.setTextFormat( Qt::PlainText );
+		shaped.staticText.prepare( QTransform(), shaped.font );
+
+		return *cache.insert( key, shaped );
+	}
 }
 
 
@@ -38,16 +95,36 @@ namespace glbarcode
 
 	struct QtRenderer::PrivateData
 	{
-		QPainter* painter;
-		QColor    color;
+		QPainter*    painter;
+		QColor       color;
+		bool         batched;
+		QPainterPath path;     /* Shapes collected while batched */
+
+		void fillPath();
 	};
 
 
+	/*
+	 * Fill shapes collected so far, and start collecting again
+	 */
+	void QtRenderer::PrivateData::fillPath()
+	{
+		if ( painter && !path.isEmpty() )
+		{
+			painter->fillPath( path, QBrush( color ) );
+		}
+
+		path = QPainterPath();
+		path.setFillRule( Qt::WindingFill ); // Union of overlapping shapes
+	}
+
+
 	QtRenderer::QtRenderer()
 	{
 		d = new QtRenderer::PrivateData;
 
 		d->painter = nullptr;
+		d->batched = false;
 	}
 
 
@@ -55,6 +132,7 @@ namespace glbarcode
 	{
 		d = new QtRenderer::PrivateData;
 
+		d->batched = false;
 		setPainter( painter );
 	}
 
@@ -79,6 +157,20 @@ namespace glbarcode
 	}
 
 
+	bool QtRenderer::batched( ) const
+	{
+		return d->batched;
+	}
+
+
+	QtRenderer& QtRenderer::setBatched( bool batched )
+	{
+		d->batched = batched;
+
+		return *this;
+	}
+
+
 	void QtRenderer::drawBegin( double w, double h )
 	{
 		if ( d->painter )
@@ -86,11 +178,16 @@ namespace glbarcode
 			d->painter->save();
 			d->color = d->painter->pen().color(); // Get current pen color
 		}
+
+		d->path = QPainterPath();
+		d->path.setFillRule( Qt::WindingFill ); // Union of overlapping shapes
 	}
 
 
 	void QtRenderer::drawEnd( )
 	{
+		d->fillPath();
+
 		if ( d->painter )
 		{
 			d->painter->restore();
@@ -100,7 +197,11 @@ namespace glbarcode
 
 	void QtRenderer::drawLine( double x, double y, double w, double h )
 	{
-		if ( d->painter )
+		if ( d->batched )
+		{
+			d->path.addRect( QRectF(x, y, w, h) ); // Same area as flat capped line
+		}
+		else if ( d->painter )
 		{
 			double x1 = x + w/2; // Offset line origin by 1/2 line width.
 
@@ -112,7 +213,11 @@ namespace glbarcode
 
 	void QtRenderer::drawBox( double x, double y, double w, double h )
 	{
-		if ( d->painter )
+		if ( d->batched )
+		{
+			d->path.addRect( QRectF(x, y, w, h) );
+		}
+		else if ( d->painter )
 		{
 			d->painter->setPen( QPen( Qt::NoPen ) );
 			d->painter->setBrush( QBrush( d->color ) );
@@ -124,30 +229,23 @@ namespace glbarcode
 
 	void QtRenderer::drawText( double x, double y, double size, const std::string& text )
 	{
+		d->fillPath(); // Keep shapes so far below text
+
 		if ( d->painter )
 		{
-			d->painter->setPen( QPen( d->color ) );
+			const ShapedText& shaped = shapedText( size, text );
 
-			QFont font;
-			font.setStyleHint( QFont::Monospace );
-			font.setFamily( "monospace" );
-			font.setPointSizeF( FONT_SCALE*size );
-
-			QFontMetricsF fm( font );
-			double xCorner = x - fm.width( QString::fromStdString(text) )/2.0;
-			double yCorner = y - fm.ascent();
-		
-			QTextLayout layout( QString::fromStdString(text), font );
-			layout.beginLayout();
-			layout.createLine();
-			layout.endLayout();
-			layout.draw( d->painter, QPointF(xCorner, yCorner) );
+			d->painter->setPen( QPen( d->color ) );
+			d->painter->setFont( shaped.font );
+			d->painter->drawStaticText( QPointF(x, y) + shaped.offset, shaped.staticText );
 		}
 	}
 
 
 	void QtRenderer::drawRing( double x, double y, double r, double w )
 	{
+		d->fillPath(); // Keep shapes so far below ring
+
 		if ( d->painter )
 		{
 			d->painter->setPen( QPen( d->color, w ) );
@@ -162,9 +260,6 @@ namespace glbarcode
 	{
 		if ( d->painter )
 		{
-			d->painter->setPen( QPen( Qt::NoPen ) );
-			d->painter->setBrush( QBrush( d->color ) );
-		
 			QPolygonF hexagon;
 			hexagon << QPointF( x,           y          )
 			        << QPointF( x + 0.433*h, y + 0.25*h )
@@ -173,7 +268,18 @@ namespace glbarcode
 			        << QPointF( x - 0.433*h, y + 0.75*h )
 			        << QPointF( x - 0.433*h, y + 0.25*h );
 
-			d->painter->drawPolygon( hexagon );
+			if ( d->batched )
+			{
+				d->path.addPolygon( hexagon );
+				d->path.closeSubpath();
+			}
+			else
+			{
+				d->painter->setPen( QPen( Qt::NoPen ) );
+				d->painter->setBrush( QBrush( d->color ) );
+
+				d->painter->drawPolygon( hexagon );
+			}
 		}
 	}
 
@@ -66,6 +66,25 @@ namespace glbarcode
                  * @returns reference to this QtRenderer object for parameter chaining
                  */
 		QtRenderer& setPainter( QPainter* painter );
+
+                /** Get "batched" parameter
+                 *
+                 * @returns batched parameter
+                 */
+		bool batched() const;
+
+                /** Set "batched" parameter
+                 *
+                 * If set, lines, boxes and hexagons of a barcode are collected into a
+                 * single path, which is filled once when rendering ends, rather than
+                 * drawn one by one.  The path is also filled before any text or ring
+                 * is drawn, so that shapes are painted in the same order either way.
+                 *
+                 * @param[in] batched true to batch shapes
+                 *
+                 * @returns reference to this QtRenderer object for parameter chaining
+                 */
+		QtRenderer& setBatched( bool batched );
 		
 
 	private:
@@ -59,3 +59,33 @@ void glbarcode::Renderer::render( double w, double h, const std::list<DrawingPri
 
 	drawEnd();
 }
+
+
+void glbarcode::Renderer::render( double w, double h, const PrimitiveBuffer& primitives )
+{
+	drawBegin( w, h );
+
+	for ( const PrimitiveBuffer::Primitive& primitive : primitives.primitives() )
+	{
+		switch ( primitive.type )
+		{
+		case PrimitiveBuffer::Type::LINE:
+			drawLine( primitive.x, primitive.y, primitive.a, primitive.b );
+			break;
+		case PrimitiveBuffer::Type::BOX:
+			drawBox( primitive.x, primitive.y, primitive.a, primitive.b );
+			break;
+		case PrimitiveBuffer::Type::TEXT:
+			drawText( primitive.x, primitive.y, primitive.a, primitives.text( primitive ) );
+			break;
+		case PrimitiveBuffer::Type::RING:
+			drawRing( primitive.x, primitive.y, primitive.a, primitive.b );
+			break;
+		case PrimitiveBuffer::Type::HEXAGON:
+			drawHexagon( primitive.x, primitive.y, primitive.a );
+			break;
+		}
+	}
+
+	drawEnd();
+}
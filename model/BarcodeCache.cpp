@@ -0,0 +1,124 @@
+/*  BarcodeCache.cpp
+ *
+ *  Copyright (C) 2017  Jim Evins <evins@snaught.com>
+ *
+ *  This file is part of gLabels-qt.
+ *
+ *  gLabels-qt is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  gLabels-qt is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with gLabels-qt.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "BarcodeCache.h"
+
+#include "glbarcode/Factory.h"
+
+
+namespace glabels
+{
+	namespace model
+	{
+
+		///
+		/// Constructor
+		///
+		BarcodeCache::BarcodeCache( int capacity )
+			: mBarcodes(qMax( capacity, 1 )), mNHits(0), mNMisses(0)
+		{
+		}
+
+
+		///
+		/// Get barcode built from data
+		///
+		/// Returns nullptr if there is no barcode style styleId.
+		///
+		glbarcode::Barcode* BarcodeCache::barcode( const QString& styleId,
+		                                           const QString& data,
+		                                           double         w,
+		                                           double         h,
+		                                           bool           checksumFlag,
+		                                           bool           textFlag )
+		{
+			// Data last, and style id length prefixed, so that keys cannot be ambiguous
+			QString key = QString( "%1:%2:%3:%4:%5:%6:" )
+				.arg( styleId.size() ).arg( styleId )
+				.arg( w, 0, 'g', 17 ).arg( h, 0, 'g', 17 )
+				.arg( int(checksumFlag) ).arg( int(textFlag) ) + data;
+
+			if ( glbarcode::Barcode* bc = mBarcodes.object( key ) )
+			{
+				mNHits++;
+				return bc;
+			}
+			mNMisses++;
+
+			glbarcode::Barcode* bc = glbarcode::Factory::createBarcode( styleId.toStdString() );
+			if ( !bc )
+			{
+				return nullptr;
+			}
+			bc->setChecksum( checksumFlag );
+			bc->setShowText( textFlag );
+			bc->build( data.toStdString(), w, h );
+
+			mBarcodes.insert( key, bc );
+			return bc;
+		}
+
+
+		///
+		/// Drop all barcodes
+		///
+		void BarcodeCache::clear()
+		{
+			mBarcodes.clear();
+		}
+
+
+		///
+		/// Number of barcodes held
+		///
+		int BarcodeCache::size() const
+		{
+			return mBarcodes.size();
+		}
+
+
+		///
+		/// Greatest number of barcodes held
+		///
+		int BarcodeCache::capacity() const
+		{
+			return mBarcodes.maxCost();
+		}
+
+
+		///
+		/// Number of barcodes found in cache
+		///
+		int BarcodeCache::nHits() const
+		{
+			return mNHits;
+		}
+
+
+		///
+		/// Number of barcodes built
+		///
+		int BarcodeCache::nMisses() const
+		{
+			return mNMisses;
+		}
+
+	}
+}
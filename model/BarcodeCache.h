@@ -0,0 +1,95 @@
+/*  BarcodeCache.h
+ *
+ *  Copyright (C) 2017  Jim Evins <evins@snaught.com>
+ *
+ *  This file is part of gLabels-qt.
+ *
+ *  gLabels-qt is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  gLabels-qt is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with gLabels-qt.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef model_BarcodeCache_h
+#define model_BarcodeCache_h
+
+
+#include "glbarcode/Barcode.h"
+
+#include <QCache>
+#include <QString>
+
+
+namespace glabels
+{
+	namespace model
+	{
+
+		///
+		/// Barcode Cache
+		///
+		/// Holds the most recently built barcodes, by style, data, requested size
+		/// and flags, so that drawing a barcode of the same data again (e.g. a
+		/// preview page drawn again, or copies of a record) does not encode it
+		/// again.  Cached barcodes are owned by the cache, and are only valid
+		/// until the next call to barcode().
+		///
+		class BarcodeCache
+		{
+
+			/////////////////////////////////
+			// Life Cycle
+			/////////////////////////////////
+		public:
+			BarcodeCache( int capacity = 32 );
+			BarcodeCache( const BarcodeCache& ) = delete;
+
+
+			/////////////////////////////////
+			// Operators
+			/////////////////////////////////
+		public:
+			BarcodeCache& operator=( const BarcodeCache& ) = delete;
+
+
+			/////////////////////////////////
+			// Public methods
+			/////////////////////////////////
+		public:
+			glbarcode::Barcode* barcode( const QString& styleId,
+			                             const QString& data,
+			                             double         w,
+			                             double         h,
+			                             bool           checksumFlag,
+			                             bool           textFlag );
+
+			void clear();
+
+			int size() const;
+			int capacity() const;
+			int nHits() const;
+			int nMisses() const;
+
+
+			/////////////////////////////////
+			// Private data
+			/////////////////////////////////
+		private:
+			QCache<QString,glbarcode::Barcode> mBarcodes;  // Least recently used are dropped first
+			int                                mNHits;
+			int                                mNMisses;
+		};
+
+	}
+}
+
+
+#endif // model_BarcodeCache_h
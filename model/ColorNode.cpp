@@ -180,16 +180,16 @@ namespace glabels
 		{
 			QColor value = QColor( 192, 192, 192, 128 );
 			
-			bool haveRecordField = mIsField && record &&
-				record->contains(mKey) &&
-				!record->value(mKey).isEmpty();
+			QString recordValue = (mIsField && record) ? record->value(mKey) : QString();
+
+			bool haveRecordField = !recordValue.isEmpty();
 			bool haveVariable = mIsField && variables &&
 				variables->contains(mKey) &&
 				!(*variables)[mKey].value().isEmpty();
 
 			if ( haveRecordField )
 			{
-				value = QColor( record->value(mKey) );
+				value = QColor( recordValue );
 			}
 			else if ( haveVariable )
 			{
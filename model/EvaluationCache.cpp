@@ -0,0 +1,145 @@
+/*  EvaluationCache.cpp
+ *
+ *  Copyright (C) 2017  Jim Evins <evins@snaught.com>
+ *
+ *  This file is part of gLabels-qt.
+ *
+ *  gLabels-qt is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  gLabels-qt is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with gLabels-qt.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "EvaluationCache.h"
+
+
+namespace glabels
+{
+	namespace model
+	{
+
+		///
+		/// Constructor
+		///
+		EvaluationCache::EvaluationCache()
+			: mActive(false), mRecord(nullptr), mVariables(nullptr)
+		{
+		}
+
+
+		///
+		/// Begin drawing label for record and variables
+		///
+		/// Record and variables must not change until end().
+		///
+		void EvaluationCache::begin( merge::Record* record, Variables* variables )
+		{
+			mTexts.clear();
+			mColors.clear();
+			mNodeTexts.clear();
+
+			mActive    = true;
+			mRecord    = record;
+			mVariables = variables;
+		}
+
+
+		///
+		/// End drawing label, forgetting all results
+		///
+		void EvaluationCache::end()
+		{
+			mTexts.clear();
+			mColors.clear();
+			mNodeTexts.clear();
+
+			mActive    = false;
+			mRecord    = nullptr;
+			mVariables = nullptr;
+		}
+
+
+		///
+		/// Is cache in use for record and variables?
+		///
+		bool EvaluationCache::isActive( const merge::Record* record, const Variables* variables ) const
+		{
+			return mActive && (record == mRecord) && (variables == mVariables);
+		}
+
+
+		///
+		/// Expand raw text, see RawText::expand()
+		///
+		QString EvaluationCache::expand( const RawText& rawText )
+		{
+			if ( !rawText.hasPlaceHolders() )
+			{
+				return rawText.toString();
+			}
+
+			auto i = mTexts.constFind( rawText.toString() );
+			if ( i != mTexts.constEnd() )
+			{
+				return i.value();
+			}
+
+			QString text = rawText.expand( mRecord, mVariables );
+			mTexts.insert( rawText.toString(), text );
+			return text;
+		}
+
+
+		///
+		/// Get color of node, see ColorNode::color()
+		///
+		QColor EvaluationCache::color( const ColorNode& colorNode )
+		{
+			if ( !colorNode.isField() )
+			{
+				return colorNode.color();
+			}
+
+			auto i = mColors.constFind( colorNode.key() );
+			if ( i != mColors.constEnd() )
+			{
+				return i.value();
+			}
+
+			QColor color = colorNode.color( mRecord, mVariables );
+			mColors.insert( colorNode.key(), color );
+			return color;
+		}
+
+
+		///
+		/// Get text of node, see TextNode::text()
+		///
+		QString EvaluationCache::text( const TextNode& textNode )
+		{
+			if ( !textNode.isField() )
+			{
+				return textNode.data();
+			}
+
+			auto i = mNodeTexts.constFind( textNode.data() );
+			if ( i != mNodeTexts.constEnd() )
+			{
+				return i.value();
+			}
+
+			QString text = textNode.text( mRecord, mVariables );
+			mNodeTexts.insert( textNode.data(), text );
+			return text;
+		}
+
+	}
+}
@@ -0,0 +1,92 @@
+/*  EvaluationCache.h
+ *
+ *  Copyright (C) 2017  Jim Evins <evins@snaught.com>
+ *
+ *  This file is part of gLabels-qt.
+ *
+ *  gLabels-qt is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  gLabels-qt is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with gLabels-qt.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef model_EvaluationCache_h
+#define model_EvaluationCache_h
+
+
+#include "ColorNode.h"
+#include "RawText.h"
+#include "TextNode.h"
+#include "Variables.h"
+
+#include "merge/Record.h"
+
+#include <QColor>
+#include <QHash>
+#include <QString>
+
+
+namespace glabels
+{
+	namespace model
+	{
+
+		///
+		/// Evaluation Cache
+		///
+		/// Holds the results of evaluating merge fields and variables while a
+		/// single label is drawn, i.e. for one record and one state of the
+		/// variables.  All objects of the label share it, so that text, colors
+		/// and file names referencing the same fields are only evaluated once,
+		/// even when drawn more than once (e.g. for shadows).
+		///
+		class EvaluationCache
+		{
+
+			/////////////////////////////////
+			// Life Cycle
+			/////////////////////////////////
+		public:
+			EvaluationCache();
+
+
+			/////////////////////////////////
+			// Public methods
+			/////////////////////////////////
+		public:
+			void begin( merge::Record* record, Variables* variables );
+			void end();
+			bool isActive( const merge::Record* record, const Variables* variables ) const;
+
+			QString expand( const RawText& rawText );
+			QColor color( const ColorNode& colorNode );
+			QString text( const TextNode& textNode );
+
+
+			/////////////////////////////////
+			// Private data
+			/////////////////////////////////
+		private:
+			bool                   mActive;
+			merge::Record*         mRecord;
+			Variables*             mVariables;
+
+			QHash<QString,QString> mTexts;      // Keyed by raw text
+			QHash<QString,QColor>  mColors;     // Keyed by field name
+			QHash<QString,QString> mNodeTexts;  // Keyed by field name
+
+		};
+
+	}
+}
+
+
+#endif // model_EvaluationCache_h
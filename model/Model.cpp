@@ -55,20 +55,23 @@ namespace glabels
 		/// Default constructor.
 		///
 		Model::Model()
-			: mUntitledInstance(0), mModified(true), mRotate(false)
+			: mUntitledInstance(0), mModified(true), mRotate(false), mLayersValid(false)
 		{
 			mVariables = new Variables();
 			mMerge = new merge::None();
 
+			connect( this, SIGNAL(changed()), this, SLOT(onChanged()) );
 			connect( mVariables, SIGNAL(changed()), this, SLOT(onVariablesChanged()) );
 		}
 
 
 		Model::Model( merge::Merge* merge, Variables* variables )
-			: mUntitledInstance(0), mModified(true), mRotate(false)
+			: mUntitledInstance(0), mModified(true), mRotate(false), mLayersValid(false)
 		{
 			mVariables = variables; // Shared
 			mMerge = merge; // Shared
+
+			connect( this, SIGNAL(changed()), this, SLOT(onChanged()) );
 		}
 
 
@@ -386,6 +389,28 @@ namespace glabels
 		}
 
 
+		///
+		/// Get names of merge fields referenced by objects
+		///
+		QStringList Model::fieldNames() const
+		{
+			QStringList names;
+
+			foreach ( ModelObject* object, mObjectList )
+			{
+				foreach ( const QString& name, object->fieldNames() )
+				{
+					if ( !names.contains( name ) )
+					{
+						names << name;
+					}
+				}
+			}
+
+			return names;
+		}
+
+
 		///
 		/// Set modified status
 		///
@@ -484,6 +509,17 @@ namespace glabels
 		}
 
 
+		///
+		/// Changed Slot
+		///
+		void Model::onChanged()
+		{
+			// Objects, or their order, may have changed
+			mLayers.clear();
+			mLayersValid = false;
+		}
+
+
 		///
 		/// Object Changed Slot
 		///
@@ -1518,10 +1554,116 @@ namespace glabels
 		///
 		void Model::draw( QPainter* painter, bool inEditor, merge::Record* record, Variables* variables ) const
 		{
+			mEvaluationCache.begin( record, variables );
+
+			if ( inEditor )
+			{
+				foreach ( ModelObject* object, mObjectList )
+				{
+					object->draw( painter, inEditor, record, variables );
+				}
+			}
+			else
+			{
+				// Objects independent of record and variables are replayed, as
+				// recorded once for all labels
+				updateLayers();
+
+				foreach ( const Layer& layer, mLayers )
+				{
+					if ( layer.object )
+					{
+						layer.object->draw( painter, false, record, variables );
+					}
+					else
+					{
+						painter->drawPicture( 0, 0, layer.picture );
+					}
+				}
+			}
+
+			mEvaluationCache.end();
+		}
+
+
+		///
+		/// Number of recorded layers of objects independent of records and variables
+		///
+		int Model::nStaticLayers() const
+		{
+			updateLayers();
+
+			int n = 0;
+			foreach ( const Layer& layer, mLayers )
+			{
+				if ( !layer.object )
+				{
+					n++;
+				}
+			}
+			return n;
+		}
+
+
+		///
+		/// Split objects into drawing layers, if not up to date
+		///
+		/// Consecutive objects without fields are recorded together into one
+		/// picture, each object with fields is a layer of its own, so that
+		/// objects are still drawn in order.
+		///
+		void Model::updateLayers() const
+		{
+			if ( mLayersValid )
+			{
+				return;
+			}
+
+			mLayers.clear();
+
+			QPainter recorder;
 			foreach ( ModelObject* object, mObjectList )
 			{
-				object->draw( painter, inEditor, record, variables );
+				if ( object->fieldNames().isEmpty() )
+				{
+					if ( mLayers.isEmpty() || mLayers.last().object )
+					{
+						if ( recorder.isActive() )
+						{
+							recorder.end();
+						}
+						mLayers.append( Layer{ nullptr, QPicture() } );
+						recorder.begin( &mLayers.last().picture );
+					}
+					object->draw( &recorder, false, nullptr, nullptr );
+				}
+				else
+				{
+					if ( recorder.isActive() )
+					{
+						recorder.end();
+					}
+					mLayers.append( Layer{ object, QPicture() } );
+				}
+			}
+			if ( recorder.isActive() )
+			{
+				recorder.end();
 			}
+
+			mLayersValid = true;
+		}
+
+
+		///
+		/// Get evaluation cache of label being drawn
+		///
+		/// Returns nullptr unless a label is being drawn for record and variables.
+		///
+		EvaluationCache* Model::evaluationCache( const merge::Record* record,
+		                                         const Variables*     variables ) const
+		{
+			return mEvaluationCache.isActive( record, variables ) ? &mEvaluationCache : nullptr;
 		}
 
 	}
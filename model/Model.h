@@ -22,6 +22,7 @@
 #define model_Model_h
 
 
+#include "EvaluationCache.h"
 #include "Settings.h"
 #include "Template.h"
 #include "Variables.h"
@@ -33,6 +34,7 @@
 #include <QList>
 #include <QObject>
 #include <QPainter>
+#include <QPicture>
 
 
 namespace glabels
@@ -117,6 +119,8 @@ namespace glabels
 
 			merge::Merge* merge() const;
 			void setMerge( merge::Merge* merge );
+
+			QStringList fieldNames() const;
 	
 		
 			/////////////////////////////////
@@ -217,11 +221,20 @@ namespace glabels
 			           merge::Record* record,
 			           Variables*     variables ) const;
 
+			EvaluationCache* evaluationCache( const merge::Record* record,
+			                                  const Variables*     variables ) const;
+
+			int nStaticLayers() const;
+
+		private:
+			void updateLayers() const;
+
 		
 			/////////////////////////////////
 			// Slots
 			/////////////////////////////////
 		private slots:
+			void onChanged();
 			void onObjectChanged();
 			void onObjectMoved();
 			void onVariablesChanged();
@@ -243,6 +256,20 @@ namespace glabels
 
 			Variables*                mVariables;
 			merge::Merge*             mMerge;
+
+			mutable EvaluationCache   mEvaluationCache;  // Of label being drawn
+
+			///
+			/// Drawing layer, either a run of objects independent of records
+			/// and variables, recorded once, or a single dependent object
+			///
+			struct Layer
+			{
+				ModelObject* object;   // Dependent object, or nullptr
+				QPicture     picture;  // Recorded objects, if no object
+			};
+			mutable QList<Layer>      mLayers;
+			mutable bool              mLayersValid;
 		};
 
 	}
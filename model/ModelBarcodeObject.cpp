@@ -307,6 +307,25 @@ namespace glabels
 		}
 
 
+		///
+		/// Merge Field Names Implementation
+		///
+		QStringList ModelBarcodeObject::fieldNames() const
+		{
+			QStringList names = ModelObject::fieldNames();
+
+			foreach ( const QString& name, mBcData.fieldNames() )
+			{
+				if ( !names.contains( name ) )
+				{
+					names << name;
+				}
+			}
+
+			return names;
+		}
+
+
 		///
 		/// Draw shadow of object
 		///
@@ -327,7 +346,7 @@ namespace glabels
 		                                     merge::Record* record,
 		                                     Variables*     variables ) const
 		{
-			QColor bcColor = mBcColorNode.color( record, variables );
+			QColor bcColor = evaluate( mBcColorNode, record, variables );
 
 			if ( inEditor )
 			{
@@ -438,6 +457,7 @@ namespace glabels
 			{
 				painter->setPen( QPen( color ) );
 				glbarcode::QtRenderer renderer(painter);
+				renderer.setBatched( true );
 				mEditorBarcode->render( renderer );
 			}
 			else
@@ -458,14 +478,16 @@ namespace glabels
 		{
 			painter->setPen( QPen( color ) );
 
-			glbarcode::Barcode* bc = glbarcode::Factory::createBarcode( mBcStyle.fullId().toStdString() );
-			bc->setChecksum(mBcChecksumFlag);
-			bc->setShowText(mBcTextFlag);
-
-			bc->build( mBcData.expand( record, variables ).toStdString(), mW.pt(), mH.pt() );
-
-			glbarcode::QtRenderer renderer(painter);
-			bc->render( renderer );
+			glbarcode::Barcode* bc = mBarcodeCache.barcode( mBcStyle.fullId(),
+			                                                evaluate( mBcData, record, variables ),
+			                                                mW.pt(), mH.pt(),
+			                                                mBcChecksumFlag, mBcTextFlag );
+			if ( bc )
+			{
+				glbarcode::QtRenderer renderer(painter);
+				renderer.setBatched( true );
+				bc->render( renderer );
+			}
 		}
 
 
@@ -491,6 +513,7 @@ namespace glabels
 			//
 			painter->setPen( QPen( color ) );
 			glbarcode::QtRenderer renderer(painter);
+			renderer.setBatched( true );
 			mEditorDefaultBarcode->render( renderer );
 
 			//
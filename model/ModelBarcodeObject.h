@@ -24,6 +24,7 @@
 
 #include "ModelObject.h"
 
+#include "BarcodeCache.h"
 #include "RawText.h"
 
 #include "glbarcode/Barcode.h"
@@ -123,6 +124,13 @@ namespace glabels
 		public:
 
 
+			///////////////////////////////////////////////////////////////
+			// Merge Field Implementations
+			///////////////////////////////////////////////////////////////
+		public:
+			QStringList fieldNames() const override;
+
+
 			///////////////////////////////////////////////////////////////
 			// Drawing operations
 			///////////////////////////////////////////////////////////////
@@ -171,6 +179,8 @@ namespace glabels
 
 			glbarcode::Barcode* mEditorBarcode;
 			glbarcode::Barcode* mEditorDefaultBarcode;
+
+			mutable BarcodeCache mBarcodeCache;  // Of final printout or preview
 		
 			QPainterPath mHoverPath;
 
@@ -109,9 +109,9 @@ namespace glabels
 		                                     merge::Record* record,
 		                                     Variables*     variables ) const
 		{
-			QColor lineColor = mLineColorNode.color( record, variables );
-			QColor fillColor = mFillColorNode.color( record, variables );
-			QColor shadowColor = mShadowColorNode.color( record, variables );
+			QColor lineColor = evaluate( mLineColorNode, record, variables );
+			QColor fillColor = evaluate( mFillColorNode, record, variables );
+			QColor shadowColor = evaluate( mShadowColorNode, record, variables );
 
 			shadowColor.setAlphaF( mShadowOpacity );
 
@@ -157,8 +157,8 @@ namespace glabels
 		                                     merge::Record* record,
 		                                     Variables*     variables ) const
 		{
-			QColor lineColor = mLineColorNode.color( record, variables );
-			QColor fillColor = mFillColorNode.color( record, variables );
+			QColor lineColor = evaluate( mLineColorNode, record, variables );
+			QColor fillColor = evaluate( mFillColorNode, record, variables );
 
 			painter->setPen( QPen( lineColor, mLineWidth.pt() ) );
 			painter->setBrush( fillColor );
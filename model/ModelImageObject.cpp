@@ -410,6 +410,22 @@ namespace glabels
 		}
 
 
+		///
+		/// Merge Field Names Implementation
+		///
+		QStringList ModelImageObject::fieldNames() const
+		{
+			QStringList names = ModelObject::fieldNames();
+
+			if ( mFilenameNode.isField() && !names.contains( mFilenameNode.data() ) )
+			{
+				names << mFilenameNode.data();
+			}
+
+			return names;
+		}
+
+
 		///
 		/// Draw shadow of object
 		///
@@ -420,7 +436,7 @@ namespace glabels
 		{
 			QRectF destRect( 0, 0, mW.pt(), mH.pt() );
 	
-			QColor shadowColor = mShadowColorNode.color( record, variables );
+			QColor shadowColor = evaluate( mShadowColorNode, record, variables );
 			shadowColor.setAlphaF( mShadowOpacity );
 
 			if ( mImage && mImage->hasAlphaChannel() && (mImage->depth() == 32) )
@@ -438,7 +454,7 @@ namespace glabels
 			}
 			else
 			{
-				QString filename = mFilenameNode.text( record, variables ).trimmed();
+				QString filename = evaluate( mFilenameNode, record, variables ).trimmed();
 				QImage* image;
 				QSvgRenderer* svgRenderer;
 				QByteArray svg;
@@ -548,7 +564,7 @@ namespace glabels
 			}
 			else if ( mFilenameNode.isField() )
 			{
-				QString filename = mFilenameNode.text( record, variables ).trimmed();
+				QString filename = evaluate( mFilenameNode, record, variables ).trimmed();
 				QImage* image;
 				QSvgRenderer* svgRenderer;
 				QByteArray svg;
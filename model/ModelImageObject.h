@@ -131,6 +131,13 @@ namespace glabels
 			///////////////////////////////////////////////////////////////
 
 
+			///////////////////////////////////////////////////////////////
+			// Merge Field Implementations
+			///////////////////////////////////////////////////////////////
+		public:
+			QStringList fieldNames() const override;
+
+
 			///////////////////////////////////////////////////////////////
 			// Drawing operations
 			///////////////////////////////////////////////////////////////
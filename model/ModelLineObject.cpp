@@ -191,8 +191,8 @@ namespace glabels
 		                                  merge::Record* record,
 		                                  Variables*     variables ) const
 		{
-			QColor lineColor = mLineColorNode.color( record, variables );
-			QColor shadowColor = mShadowColorNode.color( record, variables );
+			QColor lineColor = evaluate( mLineColorNode, record, variables );
+			QColor shadowColor = evaluate( mShadowColorNode, record, variables );
 
 			shadowColor.setAlphaF( mShadowOpacity );
 
@@ -212,7 +212,7 @@ namespace glabels
 		                                  merge::Record* record,
 		                                  Variables*     variables ) const
 		{
-			QColor lineColor = mLineColorNode.color( record, variables );
+			QColor lineColor = evaluate( mLineColorNode, record, variables );
 
 			painter->setPen( QPen( lineColor, mLineWidth.pt() ) );
 			painter->drawLine( 0, 0, mW.pt(), mH.pt() );
@@ -21,6 +21,8 @@
 #include "ModelObject.h"
 
 #include "ColorNode.h"
+#include "EvaluationCache.h"
+#include "Model.h"
 #include "Region.h"
 #include "Size.h"
 #include "TextNode.h"
@@ -970,6 +972,33 @@ namespace glabels
 		}
 
 
+		///
+		/// Virtual Merge Field Names Default Getter
+		/// (Extended by concrete class)
+		///
+		/// Names of merge fields referenced by this object, here by its color
+		/// nodes.
+		///
+		QStringList ModelObject::fieldNames() const
+		{
+			QStringList names;
+
+			QList<ColorNode> colorNodes;
+			colorNodes << mShadowColorNode << textColorNode() << lineColorNode()
+			           << fillColorNode() << bcColorNode();
+
+			foreach ( const ColorNode& colorNode, colorNodes )
+			{
+				if ( colorNode.isField() && !names.contains( colorNode.key() ) )
+				{
+					names << colorNode.key();
+				}
+			}
+
+			return names;
+		}
+
+
 		///
 		/// Set Absolute Position
 		///
@@ -1282,5 +1311,54 @@ namespace glabels
 			// empty
 		}
 
+
+		///
+		/// Expand raw text for record and variables
+		///
+		/// While the parent model draws a label, results are shared by all of
+		/// its objects, see EvaluationCache.
+		///
+		QString ModelObject::evaluate( const RawText& rawText,
+		                               merge::Record* record,
+		                               Variables*     variables ) const
+		{
+			EvaluationCache* cache = evaluationCache( record, variables );
+			return cache ? cache->expand( rawText ) : rawText.expand( record, variables );
+		}
+
+
+		///
+		/// Get color of color node for record and variables
+		///
+		QColor ModelObject::evaluate( const ColorNode& colorNode,
+		                              merge::Record*   record,
+		                              Variables*       variables ) const
+		{
+			EvaluationCache* cache = evaluationCache( record, variables );
+			return cache ? cache->color( colorNode ) : colorNode.color( record, variables );
+		}
+
+
+		///
+		/// Get text of text node for record and variables
+		///
+		QString ModelObject::evaluate( const TextNode& textNode,
+		                               merge::Record*  record,
+		                               Variables*      variables ) const
+		{
+			EvaluationCache* cache = evaluationCache( record, variables );
+			return cache ? cache->text( textNode ) : textNode.text( record, variables );
+		}
+
+
+		///
+		/// Evaluation cache of label being drawn by parent model, if any
+		///
+		EvaluationCache* ModelObject::evaluationCache( merge::Record* record, Variables* variables ) const
+		{
+			auto* model = qobject_cast<Model*>( parent() );
+			return model ? model->evaluationCache( record, variables ) : nullptr;
+		}
+
 	}
 }
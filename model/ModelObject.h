@@ -26,6 +26,7 @@
 #include "Distance.h"
 #include "Handles.h"
 #include "Outline.h"
+#include "RawText.h"
 #include "TextNode.h"
 #include "Variables.h"
 
@@ -36,6 +37,7 @@
 #include <QFont>
 #include <QMatrix>
 #include <QPainter>
+#include <QStringList>
 
 
 namespace glabels
@@ -44,6 +46,7 @@ namespace glabels
 	{
 
 		// Forward References
+		class EvaluationCache;
 		class Region;
 		class Size;
 
@@ -388,6 +391,13 @@ namespace glabels
 			virtual bool canLineWidth() const;
 
 
+			///////////////////////////////////////////////////////////////
+			// Merge Fields (Extended by concrete classes.)
+			///////////////////////////////////////////////////////////////
+		public:
+			virtual QStringList fieldNames() const;
+
+
 			///////////////////////////////////////////////////////////////
 			// Position and Size methods
 			///////////////////////////////////////////////////////////////
@@ -434,6 +444,26 @@ namespace glabels
 
 			virtual void sizeUpdated();
 
+
+			///////////////////////////////////////////////////////////////
+			// Evaluation of merge fields and variables, while drawing
+			///////////////////////////////////////////////////////////////
+		protected:
+			QString evaluate( const RawText&  rawText,
+			                  merge::Record*  record,
+			                  Variables*      variables ) const;
+
+			QColor evaluate( const ColorNode& colorNode,
+			                 merge::Record*   record,
+			                 Variables*       variables ) const;
+
+			QString evaluate( const TextNode& textNode,
+			                  merge::Record*  record,
+			                  Variables*      variables ) const;
+
+		private:
+			EvaluationCache* evaluationCache( merge::Record* record, Variables* variables ) const;
+
 		
 			///////////////////////////////////////////////////////////////
 			// Protected Members
@@ -514,6 +514,25 @@ namespace glabels
 		}
 
 
+		///
+		/// Merge Field Names Implementation
+		///
+		QStringList ModelTextObject::fieldNames() const
+		{
+			QStringList names = ModelObject::fieldNames();
+
+			foreach ( const QString& name, mText.fieldNames() )
+			{
+				if ( !names.contains( name ) )
+				{
+					names << name;
+				}
+			}
+
+			return names;
+		}
+
+
 		///
 		/// Draw shadow of object
 		///
@@ -522,11 +541,11 @@ namespace glabels
 		                                  merge::Record* record,
 		                                  Variables*     variables ) const
 		{
-			QColor textColor = mTextColorNode.color( record, variables );
+			QColor textColor = evaluate( mTextColorNode, record, variables );
 
 			if ( textColor.alpha() )
 			{
-				QColor shadowColor = mShadowColorNode.color( record, variables );
+				QColor shadowColor = evaluate( mShadowColorNode, record, variables );
 				shadowColor.setAlphaF( mShadowOpacity );
 
 				if ( inEditor )
@@ -549,7 +568,7 @@ namespace glabels
 		                                  merge::Record* record,
 		                                  Variables*     variables ) const
 		{
-			QColor textColor = mTextColorNode.color( record, variables );
+			QColor textColor = evaluate( mTextColorNode, record, variables );
 
 			if ( inEditor )
 			{
@@ -720,7 +739,7 @@ namespace glabels
 			QFontMetricsF fontMetrics( font );
 			double dy = fontMetrics.lineSpacing() * mTextLineSpacing;
 
-			QTextDocument document( mText.expand( record, variables ) );
+			QTextDocument document( evaluate( mText, record, variables ) );
 
 			QList<QTextLayout*> layouts;
 
@@ -806,7 +825,7 @@ namespace glabels
 			textOption.setAlignment( mTextHAlign );
 			textOption.setWrapMode( mTextWrapMode );
 
-			QTextDocument document( mText.expand( record, variables ) );
+			QTextDocument document( evaluate( mText, record, variables ) );
 
 			double candidateSize = mFontSize;
 			while ( candidateSize > 1.0 )
@@ -182,6 +182,13 @@ namespace glabels
 			bool canText() const override;
 
 
+			///////////////////////////////////////////////////////////////
+			// Merge Field Implementations
+			///////////////////////////////////////////////////////////////
+		public:
+			QStringList fieldNames() const override;
+
+
 			///////////////////////////////////////////////////////////////
 			// Drawing operations
 			///////////////////////////////////////////////////////////////
@@ -26,8 +26,18 @@
 #include "merge/None.h"
 #include "merge/Record.h"
 
+#include <QAtomicInt>
+#include <QFile>
+#include <QImage>
+#include <QImageWriter>
+#include <QMap>
+#include <QPicture>
+#include <QRunnable>
+#include <QThreadPool>
 #include <QtDebug>
 
+#include <algorithm>
+
 
 namespace glabels
 {
@@ -43,13 +53,164 @@ namespace glabels
 			const double labelOutlineWidth = 0.25;
 			const double tickOffset = 2.25;
 			const double tickLength = 18;
+
+			const int pagesPerJobPerBatch = 4;
+
+			const int maxStampsPerPage = 64;
+
+			const quint32 pictureFileMagic   = 0x474c5047; // "GLPG"
+			const qint32  pictureFileVersion = 1;
 		}
 
 
+		///
+		/// Page Recorder
+		///
+		/// Records every nJobs'th page of a batch into its own picture, using the
+		/// job's own render cursor.  The cursor persists from batch to batch, so
+		/// that it only ever moves forward through the merge records.
+		///
+		class PageRenderer::PageRecorder : public QRunnable
+		{
+		public:
+			PageRecorder( const PageRenderer* renderer,
+			              Cursor*             cursor,
+			              QPicture*           pictures,
+			              int                 iFirstPage,
+			              int                 nPages,
+			              int                 iJob,
+			              int                 nJobs )
+				: mRenderer(renderer), mCursor(cursor), mPictures(pictures),
+				  mIFirstPage(iFirstPage), mNPages(nPages), mIJob(iJob), mNJobs(nJobs)
+			{
+			}
+
+			void run() override
+			{
+				for ( int i = mIJob; i < mNPages; i += mNJobs )
+				{
+					mRenderer->seekCursor( *mCursor, mIFirstPage + i );
+					mRenderer->recordPage( &mPictures[i], mIFirstPage + i, *mCursor );
+				}
+			}
+
+		private:
+			const PageRenderer* mRenderer;
+			Cursor*             mCursor;
+			QPicture*           mPictures;
+			int                 mIFirstPage;
+			int                 mNPages;
+			int                 mIJob;
+			int                 mNJobs;
+		};
+
+
+		///
+		/// Image Writer
+		///
+		/// Renders every nJobs'th page (or label) of its range, starting at iJob,
+		/// into its own image file, using the job's own render cursor.  The cursor
+		/// is set up beforehand by the calling thread, with a private copy of the
+		/// model and its variables.
+		///
+		class PageRenderer::ImageWriter : public QRunnable
+		{
+		public:
+			ImageWriter( const PageRenderer* renderer,
+			             Cursor*             cursor,
+			             const QString&      fileNameTemplate,
+			             const QByteArray&   format,
+			             double              dpi,
+			             bool                perLabel,
+			             int                 iFirstImage,
+			             int                 nImages,
+			             int                 nImagesTotal,
+			             int                 iJob,
+			             int                 nJobs,
+			             QAtomicInt*         nErrors )
+				: mRenderer(renderer), mCursor(cursor),
+				  mFileNameTemplate(fileNameTemplate), mFormat(format), mDpi(dpi), mPerLabel(perLabel),
+				  mIFirstImage(iFirstImage), mNImages(nImages), mIJob(iJob), mNJobs(nJobs), mNErrors(nErrors)
+			{
+				mNDigits = QString::number( nImagesTotal ).size();
+			}
+
+			void run() override
+			{
+				QSizeF size = mRenderer->pageRect().size();
+				if ( mPerLabel )
+				{
+					size = QSizeF( mCursor->model->frame()->w().pt(), mCursor->model->frame()->h().pt() );
+				}
+
+				double scale  = mDpi / 72.0;
+				int    dpm    = qRound( mDpi / 0.0254 );
+				bool   isMono = (mFormat == "pbm");
+
+				for ( int i = mIFirstImage + mIJob; i < mIFirstImage + mNImages; i += mNJobs )
+				{
+					QImage image( qRound( size.width()*scale ), qRound( size.height()*scale ), QImage::Format_RGB32 );
+					image.setDotsPerMeterX( dpm );
+					image.setDotsPerMeterY( dpm );
+					image.fill( Qt::white );
+
+					{
+						QPainter painter( &image );
+						if ( !isMono )
+						{
+							// Antialias, unless thresholding down to a bitmap
+							painter.setRenderHint( QPainter::Antialiasing, true );
+							painter.setRenderHint( QPainter::SmoothPixmapTransform, true );
+						}
+						painter.scale( scale, scale );
+
+						if ( mPerLabel )
+						{
+							mRenderer->seekCursorToItem( *mCursor, i );
+							mRenderer->printLabelItem( &painter, *mCursor );
+						}
+						else
+						{
+							mRenderer->seekCursor( *mCursor, i );
+							mRenderer->printPage( &painter, i, *mCursor );
+						}
+					}
+
+					if ( isMono )
+					{
+						image = image.convertToFormat( QImage::Format_Mono, Qt::ThresholdDither );
+					}
+
+					QString fileName = mFileNameTemplate.arg( i + 1, mNDigits, 10, QChar('0') );
+					QImageWriter writer( fileName, mFormat );
+					if ( !writer.write( image ) )
+					{
+						qWarning() << "Error: cannot write" << fileName << ":" << writer.errorString();
+						mNErrors->ref();
+					}
+				}
+			}
+
+		private:
+			const PageRenderer* mRenderer;
+			Cursor*             mCursor;
+			QString             mFileNameTemplate;
+			QByteArray          mFormat;
+			double              mDpi;
+			bool                mPerLabel;
+			int                 mIFirstImage;
+			int                 mNImages;
+			int                 mNDigits;
+			int                 mIJob;
+			int                 mNJobs;
+			QAtomicInt*         mNErrors;
+		};
+
+
 		PageRenderer::PageRenderer( const Model* model )
 			: mModel(nullptr), mMerge(nullptr), mVariables(nullptr), mNCopies(0), mStartItem(0), mLastItem(0),
 			  mPrintOutlines(false), mPrintCropMarks(false), mPrintReverse(false),
-			  mIPage(0), mIsMerge(false), mNPages(0), mNItemsPerPage(0)
+			  mIPage(0), mPrintFirstPage(0), mPrintNPages(-1), mIsMerge(false), mNPages(0), mNItemsPerPage(0)
 		{
 			if ( model )
 			{
@@ -154,6 +315,20 @@ namespace glabels
 			emit changed();
 		}
 
+
+		///
+		/// Restrict printing to nPages pages, starting at iFirstPage
+		///
+		/// If nPages < 0, print through the last page.  The range only affects
+		/// print(), printImages() and printPictures(); page numbering, item numbering
+		/// and user variables are the same as if the whole job was printed.
+		///
+		void PageRenderer::setPrintRange( int iFirstPage, int nPages )
+		{
+			mPrintFirstPage = iFirstPage;
+			mPrintNPages    = nPages;
+		}
+
 	
 		int PageRenderer::nItems() const
 		{
@@ -233,29 +408,425 @@ namespace glabels
 		///
 		/// Print
 		///
-		void PageRenderer::print( QPrinter* printer ) const
+		/// Each page is recorded, then replayed into the printer.  Pages are
+		/// recorded in a single forward pass: the render cursor carries item, record
+		/// and user variable state from one page to the next.  If nJobs > 1, pages
+		/// are instead recorded concurrently by nJobs threads.  Recording a page
+		/// does not depend on any other page, so the printer output is the same
+		/// for any number of jobs.  Full pages of a simple project without
+		/// incrementing variables are all the same, so are only recorded once.
+		///
+		void PageRenderer::print( QPrinter* printer, int nJobs ) const
+		{
+			QPainter painter;
+			beginPrint( printer, &painter, pageRect().size() );
+
+			printPages( printer, &painter, nullptr, nJobs );
+		}
+
+
+		///
+		/// Print to picture file
+		///
+		/// The pages of the print range are recorded, in order, into fileName.  Files
+		/// recorded by separate processes, each printing its own range of pages of
+		/// the same job, can later be combined with printPictureFiles() without
+		/// rendering any labels again.
+		///
+		/// Returns false if the file could not be written.
+		///
+		bool PageRenderer::printPictures( const QString& fileName, int nJobs ) const
+		{
+			QFile file( fileName );
+			if ( !file.open( QFile::WriteOnly ) )
+			{
+				qWarning() << "Error: cannot open" << fileName << ":" << file.errorString();
+				return false;
+			}
+
+			int iFirstPage, nPages;
+			printRange( iFirstPage, nPages );
+
+			QDataStream stream( &file );
+			stream.setVersion( QDataStream::Qt_5_0 );
+			stream << pictureFileMagic << pictureFileVersion
+			       << pageRect().size() << qint32(iFirstPage) << qint32(nPages);
+
+			printPages( nullptr, nullptr, &stream, nJobs );
+
+			if ( stream.status() != QDataStream::Ok )
+			{
+				qWarning() << "Error: cannot write" << fileName << ":" << file.errorString();
+				return false;
+			}
+			return true;
+		}
+
+
+		///
+		/// Print picture files, in page order
+		///
+		/// Pages recorded by printPictures() are replayed into the printer.  The
+		/// files may be given in any order, but together must cover a contiguous
+		/// range of pages exactly once.
+		///
+		/// Returns false if any file could not be read.
+		///
+		bool PageRenderer::printPictureFiles( QPrinter* printer, const QStringList& fileNames )
+		{
+			QMap<int,QString> fileNameByFirstPage;
+			QMap<int,int>     nPagesByFirstPage;
+			QSizeF            pageSize;
+
+			// Read headers
+			foreach ( const QString& fileName, fileNames )
+			{
+				QFile file( fileName );
+				if ( !file.open( QFile::ReadOnly ) )
+				{
+					qWarning() << "Error: cannot open" << fileName << ":" << file.errorString();
+					return false;
+				}
+
+				QDataStream stream( &file );
+				stream.setVersion( QDataStream::Qt_5_0 );
+
+				quint32 magic;
+				qint32  version;
+				QSizeF  size;
+				qint32  iFirstPage, nPages;
+				stream >> magic >> version >> size >> iFirstPage >> nPages;
+
+				if ( (stream.status() != QDataStream::Ok) || (magic != pictureFileMagic) )
+				{
+					qWarning() << "Error:" << fileName << "is not a gLabels picture file.";
+					return false;
+				}
+				if ( version != pictureFileVersion )
+				{
+					qWarning() << "Error:" << fileName << "has unsupported version" << version;
+					return false;
+				}
+				if ( !pageSize.isEmpty() && (size != pageSize) )
+				{
+					qWarning() << "Error:" << fileName << "has a different page size.";
+					return false;
+				}
+				if ( fileNameByFirstPage.contains( iFirstPage ) )
+				{
+					qWarning() << "Error:" << fileName << "and" << fileNameByFirstPage[iFirstPage]
+					           << "both start at page" << iFirstPage + 1;
+					return false;
+				}
+
+				pageSize = size;
+				fileNameByFirstPage[iFirstPage] = fileName;
+				nPagesByFirstPage[iFirstPage]   = nPages;
+			}
+
+			// Check that files follow on from each other
+			int iNextPage = fileNameByFirstPage.isEmpty() ? 0 : fileNameByFirstPage.firstKey();
+			foreach ( int iFirstPage, fileNameByFirstPage.keys() )
+			{
+				if ( iFirstPage != iNextPage )
+				{
+					qWarning() << "Error:" << fileNameByFirstPage[iFirstPage] << "starts at page" << iFirstPage + 1
+					           << ", expected page" << iNextPage + 1;
+					return false;
+				}
+				iNextPage += nPagesByFirstPage[iFirstPage];
+			}
+
+			if ( fileNameByFirstPage.isEmpty() )
+			{
+				return true;
+			}
+
+			QPainter painter;
+			beginPrint( printer, &painter, pageSize );
+
+			// Replay pages, one at a time
+			bool isFirstPage = true;
+			foreach ( const QString& fileName, fileNameByFirstPage.values() )
+			{
+				QFile file( fileName );
+				if ( !file.open( QFile::ReadOnly ) )
+				{
+					qWarning() << "Error: cannot open" << fileName << ":" << file.errorString();
+					return false;
+				}
+
+				QDataStream stream( &file );
+				stream.setVersion( QDataStream::Qt_5_0 );
+
+				quint32 magic;
+				qint32  version;
+				QSizeF  size;
+				qint32  iFirstPage, nPages;
+				stream >> magic >> version >> size >> iFirstPage >> nPages;
+
+				for ( int i = 0; i < nPages; i++ )
+				{
+					QPicture picture;
+					stream >> picture;
+					if ( stream.status() != QDataStream::Ok )
+					{
+						qWarning() << "Error: cannot read page" << iFirstPage + i + 1 << "from" << fileName;
+						return false;
+					}
+
+					if ( !isFirstPage )
+					{
+						printer->newPage();
+					}
+					isFirstPage = false;
+
+					painter.drawPicture( 0, 0, picture );
+				}
+			}
+
+			return true;
+		}
+
+
+		///
+		/// Prepare printer and begin painting in points
+		///
+		void PageRenderer::beginPrint( QPrinter* printer, QPainter* painter, const QSizeF& pageSize )
 		{
-			QSizeF pageSize( mModel->tmplate()->pageWidth().pt(), mModel->tmplate()->pageHeight().pt() );
 			printer->setPageSize( QPageSize(pageSize, QPageSize::Point) );
 			printer->setFullPage( true );
 			printer->setPageMargins( 0, 0, 0, 0, QPrinter::Point );
 
-			QPainter painter( printer );
-			
+			painter->begin( printer );
+
 			QRectF rectPx  = printer->paperRect( QPrinter::DevicePixel );
 			QRectF rectPts = printer->paperRect( QPrinter::Point );
-			painter.scale( rectPx.width()/rectPts.width(), rectPx.height()/rectPts.height() );
+			painter->scale( rectPx.width()/rectPts.width(), rectPx.height()/rectPts.height() );
+		}
+
+
+		///
+		/// Print range, clamped to the pages of the job
+		///
+		void PageRenderer::printRange( int& iFirstPage, int& nPages ) const
+		{
+			iFirstPage = std::max( 0, std::min( mPrintFirstPage, mNPages ) );
+
+			nPages = mNPages - iFirstPage;
+			if ( mPrintNPages >= 0 )
+			{
+				nPages = std::min( nPages, mPrintNPages );
+			}
+		}
 
 
-			for ( int iPage = 0; iPage < mNPages; iPage++ )
+		///
+		/// Print pages of print range, either into the printer or the picture stream
+		///
+		void PageRenderer::printPages( QPrinter* printer, QPainter* painter, QDataStream* stream, int nJobs ) const
+		{
+			int iFirstPage, nPages;
+			printRange( iFirstPage, nPages );
+
+			// Identical pages are rendered once, so there is nothing to share between jobs
+			bool pagesRepeat = arePagesRepeated();
+
+			if ( (nJobs > 1) && (nPages > 1) && !pagesRepeat )
 			{
-				if ( iPage )
+				printParallel( printer, painter, stream, nJobs );
+				return;
+			}
+
+			Cursor cursor;
+			initCursor( cursor, mModel, mVariables );
+			seekCursor( cursor, iFirstPage );
+
+			QPicture repeatedPage;
+			bool     hasRepeatedPage = false;
+			bool     isCursorValid   = true;
+
+			for ( int iPage = iFirstPage; iPage < iFirstPage + nPages; iPage++ )
+			{
+				if ( !isCursorValid )
+				{
+					seekCursor( cursor, iPage );
+					isCursorValid = true;
+				}
+
+				if ( pagesRepeat && isFullPage( iPage ) )
+				{
+					if ( hasRepeatedPage )
+					{
+						// Cursor is not moved past the skipped page
+						isCursorValid = false;
+					}
+					else
+					{
+						recordPage( &repeatedPage, iPage, cursor );
+						hasRepeatedPage = true;
+					}
+
+					outputPage( printer, painter, stream, repeatedPage, iPage == iFirstPage );
+				}
+				else
+				{
+					QPicture picture;
+					recordPage( &picture, iPage, cursor );
+
+					outputPage( printer, painter, stream, picture, iPage == iFirstPage );
+				}
+			}
+		}
+
+
+		///
+		/// Record page into picture, advancing render cursor
+		///
+		/// All modes of printing draw pages from these recordings, so that their
+		/// output is the same.
+		///
+		void PageRenderer::recordPage( QPicture* picture, int iPage, Cursor& cursor ) const
+		{
+			QPainter painter( picture );
+			printPage( &painter, iPage, cursor );
+		}
+
+
+		///
+		/// Output recorded page, either into the printer or the picture stream
+		///
+		void PageRenderer::outputPage( QPrinter*       printer,
+		                               QPainter*       painter,
+		                               QDataStream*    stream,
+		                               const QPicture& picture,
+		                               bool            isFirstPage )
+		{
+			if ( stream )
+			{
+				*stream << picture;
+			}
+			else
+			{
+				if ( !isFirstPage )
 				{
 					printer->newPage();
 				}
 
-				printPage( &painter, iPage );
+				painter->drawPicture( 0, 0, picture );
+			}
+		}
+
+
+		///
+		/// Are all full pages identical?
+		///
+		/// This is the case for a simple project, unless the labels reference
+		/// a variable that is incremented, so that a full page can be rendered
+		/// once and replayed for every other full page.
+		///
+		bool PageRenderer::arePagesRepeated() const
+		{
+			if ( !mModel || mIsMerge )
+			{
+				return false;
+			}
+
+			foreach ( const QString& name, mModel->fieldNames() )
+			{
+				const Variable* variable = mVariables->variable( name );
+				if ( variable && (variable->increment() != Variable::Increment::NEVER) )
+				{
+					return false;
+				}
+			}
+
+			return true;
+		}
+
+
+		///
+		/// Is every label position of page filled by an item of the job?
+		///
+		bool PageRenderer::isFullPage( int iPage ) const
+		{
+			int iFirstItem = iPage*mNItemsPerPage;
+			int iLastItem  = iFirstItem + mNItemsPerPage - 1;
+
+			return (iFirstItem >= mStartItem) && (iLastItem <= mLastItem);
+		}
+
+
+		///
+		/// Print using nJobs threads
+		///
+		/// Pages are recorded in batches of a few pages per job, so that only a
+		/// bounded number of recorded pages are held in memory at any time.  Each job
+		/// draws with its own copy of the model objects and user variables, and
+		/// keeps its own render cursor from one batch to the next.  The cursors share
+		/// one copy of the merge records, see loadJobRecords().
+		///
+		void PageRenderer::printParallel( QPrinter* printer, QPainter* painter, QDataStream* stream, int nJobs ) const
+		{
+			int iFirstPrintPage, nPrintPages;
+			printRange( iFirstPrintPage, nPrintPages );
+			int iEndPage = iFirstPrintPage + nPrintPages;
+
+			merge::Merge* jobRecords = loadJobRecords();
+
+			QList<Model*>     models;
+			QList<Variables*> variablesList;
+			QList<Cursor*>    cursors;
+			for ( int iJob = 0; iJob < nJobs; iJob++ )
+			{
+				auto* variables = mVariables->clone();
+				auto* model = new Model( mModel->merge(), variables );
+				model->restore( mModel );
+
+				variablesList << variables;
+				models << model;
+
+				auto* cursor = new Cursor;
+				initCursor( *cursor, model, variables );
+				if ( jobRecords )
+				{
+					cursor->records.setMerge( jobRecords );
+				}
+				cursors << cursor;
+			}
+
+			// Records outlive their merge object
+			delete jobRecords;
+
+			QThreadPool pool;
+			pool.setMaxThreadCount( nJobs );
+
+			int nPagesPerBatch = nJobs * pagesPerJobPerBatch;
+			QVector<QPicture> pictures;
+
+			for ( int iFirstPage = iFirstPrintPage; iFirstPage < iEndPage; iFirstPage += nPagesPerBatch )
+			{
+				int nPages = std::min( nPagesPerBatch, iEndPage - iFirstPage );
+
+				pictures.clear();
+				pictures.resize( nPages );
+
+				for ( int iJob = 0; iJob < nJobs; iJob++ )
+				{
+					pool.start( new PageRecorder( this, cursors[iJob], pictures.data(),
+					                              iFirstPage, nPages, iJob, nJobs ) );
+				}
+				pool.waitForDone();
+
+				for ( int i = 0; i < nPages; i++ )
+				{
+					outputPage( printer, painter, stream, pictures[i], iFirstPage + i == iFirstPrintPage );
+				}
 			}
+
+			qDeleteAll( cursors );
+			qDeleteAll( models );
+			qDeleteAll( variablesList );
 		}
 
 
@@ -273,223 +844,538 @@ namespace glabels
 		///
 		void PageRenderer::printPage( QPainter* painter, int iPage ) const
 		{
+			printPage( painter, iPage, mVariables );
+		}
+
+
+		///
+		/// Print page, using variables as scratch state
+		///
+		/// Each page is rendered independently of any other, in time proportional
+		/// to the number of labels on the page.  Passing a separate variables object
+		/// (e.g. a clone of the model's variables) to each caller allows pages to be
+		/// rendered out of order or concurrently.
+		///
+		void PageRenderer::printPage( QPainter* painter, int iPage, Variables* variables ) const
+		{
+			Cursor cursor;
+			initCursor( cursor, mModel, variables );
+			seekCursor( cursor, iPage );
+
+			printPage( painter, iPage, cursor );
+		}
+
+
+		///
+		/// Print single label, using variables as scratch state
+		///
+		/// The iItem'th item of the job is drawn at the origin of the painter,
+		/// rather than at its position on the page.
+		///
+		void PageRenderer::printItem( QPainter* painter, int iItem, Variables* variables ) const
+		{
+			if ( !mModel || (iItem < 0) || (iItem >= mNItems) )
+			{
+				return;
+			}
+
+			Cursor cursor;
+			initCursor( cursor, mModel, variables );
+			seekCursorToItem( cursor, iItem );
+
+			printLabelItem( painter, cursor );
+		}
+
+
+		///
+		/// Print to image files using nJobs threads
+		///
+		/// One image is written per page of the print range, or per label on those
+		/// pages if perLabel is set.  Image file names are created from
+		/// fileNameTemplate by replacing "%1" with the image number within the whole
+		/// job (starting at 1, zero-padded to a common width).  Images are
+		/// rendered and encoded independently of each other, so each job draws with
+		/// its own copy of the model objects and user variables, through its own
+		/// render cursor.  Cursors are set up here, as setting up a cursor reads
+		/// the merge object, which is not safe to share between threads.
+		///
+		/// Returns false if any image could not be written.
+		///
+		bool PageRenderer::printImages( const QString&    fileNameTemplate,
+		                                const QByteArray& format,
+		                                double            dpi,
+		                                bool              perLabel,
+		                                int               nJobs ) const
+		{
+			if ( !mModel || (dpi <= 0) )
+			{
+				return false;
+			}
+
+			int iFirstPage, nPages;
+			printRange( iFirstPage, nPages );
+
+			int iFirstImage  = iFirstPage;
+			int nImages      = nPages;
+			int nImagesTotal = mNPages;
+			if ( perLabel )
+			{
+				iFirstImage  = firstItemOnPage( iFirstPage );
+				nImages      = firstItemOnPage( iFirstPage + nPages ) - iFirstImage;
+				nImagesTotal = mNItems;
+			}
+			nJobs = std::max( 1, std::min( nJobs, nImages ) );
+
+			merge::Merge* jobRecords = (nJobs > 1) ? loadJobRecords() : nullptr;
+
+			QList<Model*>     models;
+			QList<Variables*> variablesList;
+			QList<Cursor*>    cursors;
+			for ( int iJob = 0; iJob < nJobs; iJob++ )
+			{
+				auto* variables = mVariables->clone();
+				auto* model = new Model( mModel->merge(), variables );
+				model->restore( mModel );
+
+				variablesList << variables;
+				models << model;
+
+				auto* cursor = new Cursor;
+				initCursor( *cursor, model, variables );
+				if ( jobRecords )
+				{
+					cursor->records.setMerge( jobRecords );
+				}
+				cursors << cursor;
+			}
+
+			// Records outlive their merge object
+			delete jobRecords;
+
+			QAtomicInt nErrors( 0 );
+
+			QThreadPool pool;
+			pool.setMaxThreadCount( nJobs );
+			for ( int iJob = 0; iJob < nJobs; iJob++ )
+			{
+				pool.start( new ImageWriter( this, cursors[iJob],
+				                             fileNameTemplate, format, dpi, perLabel,
+				                             iFirstImage, nImages, nImagesTotal, iJob, nJobs, &nErrors ) );
+			}
+			pool.waitForDone();
+
+			qDeleteAll( cursors );
+			qDeleteAll( models );
+			qDeleteAll( variablesList );
+
+			return nErrors.load() == 0;
+		}
+
+
+		///
+		/// Initialize render cursor to the first item of the job
+		///
+		void PageRenderer::initCursor( Cursor& cursor, const Model* model, Variables* variables ) const
+		{
+			cursor.model   = model;
+			cursor.iCopy   = 0;
+			cursor.iItem   = mStartItem;
+			cursor.iRecord = 0;
+			cursor.iPage   = 0;
+
+			cursor.records.setMerge( (mModel && mIsMerge) ? mMerge : nullptr );
+
+			cursor.variables = variables;
+			cursor.variables->resetVariables();
+
+			// Labels can only repeat if no variable they reference changes from item to item
+			cursor.fieldNames = model ? model->fieldNames() : QStringList();
+			cursor.canStamp = true;
+			foreach ( const QString& name, cursor.fieldNames )
+			{
+				const Variable* variable = variables->variable( name );
+				if ( variable && (variable->increment() == Variable::Increment::PER_ITEM) )
+				{
+					cursor.canStamp = false;
+				}
+			}
+			cursor.stamps.setMaxCost( maxStampsPerPage );
+			cursor.stamps.clear();
+		}
+
+
+		///
+		/// Load merge records to be shared by the render cursors of several jobs
+		///
+		/// Each job reads records in order, but skips the records of the other jobs,
+		/// so a cursor streaming records from the source would read all of it, once
+		/// per job.  Instead, the records are read once, into a copy of the merge
+		/// object, and then shared by all cursors.  The copy can be deleted once the
+		/// cursors are set.  Returns nullptr if the records of the merge object are
+		/// already loaded (and so already shared), or if there is no merge.
+		///
+		merge::Merge* PageRenderer::loadJobRecords() const
+		{
+			if ( !mModel || !mIsMerge || mMerge->isLoaded() )
+			{
+				return nullptr;
+			}
+
+			merge::Merge* records = mMerge->clone();
+			records->load();
+			return records;
+		}
+
+
+		///
+		/// Index of the first item of the job on or after iPage
+		///
+		/// Returns nItems() if there is no such item.
+		///
+		int PageRenderer::firstItemOnPage( int iPage ) const
+		{
+			if ( !mModel || (iPage <= 0) || (mNItems <= 0) )
+			{
+				return 0;
+			}
+
+			int k;
+			if ( !mIsMerge || mAreGroupsContiguous )
+			{
+				k = std::max( iPage*mNItemsPerPage - mStartItem, 0 );
+			}
+			else
+			{
+				int g = iPage / mNPagesPerGroup;
+				int r = std::max( (iPage % mNPagesPerGroup)*mNItemsPerPage - mStartItem, 0 );
+				k = (g < mNGroups) ? g*mNItemsPerGroup + std::min( r, mNItemsPerGroup ) : mNItems;
+			}
+
+			return std::min( k, mNItems );
+		}
+
+
+		///
+		/// Position render cursor at the first item of iPage
+		///
+		void PageRenderer::seekCursor( Cursor& cursor, int iPage ) const
+		{
+			seekCursorToItem( cursor, firstItemOnPage( iPage ) );
+		}
+
+
+		///
+		/// Position render cursor at the k'th item of the job
+		///
+		/// Items are visited in groups of nItemsPerGroup (one group per copy when
+		/// collated, one per record otherwise), so both the cursor position and the
+		/// number of item, copy and page increments seen so far follow directly from
+		/// the group index (g) and the index within the group (r).
+		///
+		void PageRenderer::seekCursorToItem( Cursor& cursor, int k ) const
+		{
+			if ( !mModel || (k <= 0) )
+			{
+				// First item of job, cursor already positioned
+				return;
+			}
+
+			int n = mNItemsPerPage;
+			int s = mStartItem;
+
+			int nGroups, nItemsPerGroup;
+			groupSize( cursor, nGroups, nItemsPerGroup );
+			if ( (nGroups <= 0) || (nItemsPerGroup <= 0) )
+			{
+				return;
+			}
+
+			int g = k / nItemsPerGroup;
+			int r = k % nItemsPerGroup;
+
+			if ( g >= nGroups )
+			{
+				// Past end of job, nothing left to print
+				cursor.iCopy   = mNCopies;
+				cursor.iRecord = cursor.records.size();
+				cursor.iPage   = mNPages;
+				return;
+			}
+
+			// Position and number of page increments before this item
+			int nPageIncrements;
+			if ( !mIsMerge || mAreGroupsContiguous )
+			{
+				cursor.iItem    = s + k;
+				nPageIncrements = (s + k)/n - s/n;
+			}
+			else
+			{
+				cursor.iItem = g*mNPagesPerGroup*n + s + r;
+
+				int nPerGroup   = (s + nItemsPerGroup - 1)/n - s/n;
+				int nTransition = (s % n == 0) ? 1 : 0; // Each new group starts a page
+				nPageIncrements = g*(nPerGroup + nTransition) + (s + r)/n - s/n;
+			}
+			cursor.iPage = cursor.iItem / n;
+
+			// Position and number of copy increments before this item
+			int nCopyIncrements;
+			if ( !mIsMerge )
+			{
+				cursor.iCopy    = k;
+				nCopyIncrements = k;
+			}
+			else if ( mIsCollated )
+			{
+				cursor.iCopy    = g;
+				cursor.iRecord  = r;
+				nCopyIncrements = g;
+			}
+			else
+			{
+				cursor.iCopy    = r;
+				cursor.iRecord  = g;
+				nCopyIncrements = r; // "On copy" variables are reset with each record
+			}
+
+			cursor.variables->setVariablesAt( k, nCopyIncrements, nPageIncrements );
+		}
+
+
+		///
+		/// Number of item groups and items per group visited by the render cursor
+		///
+		void PageRenderer::groupSize( const Cursor& cursor, int& nGroups, int& nItemsPerGroup ) const
+		{
+			if ( !mIsMerge )
+			{
+				nGroups        = 1;
+				nItemsPerGroup = mNCopies;
+			}
+			else if ( mIsCollated )
+			{
+				nGroups        = mNCopies;
+				nItemsPerGroup = cursor.records.size();
+			}
+			else
+			{
+				nGroups        = cursor.records.size();
+				nItemsPerGroup = mNCopies;
+			}
+		}
+
+
+		///
+		/// Print page, advancing render cursor
+		///
+		/// The cursor is forward-only: it must not already be past iPage.  On
+		/// return it is positioned at the first item following iPage.
+		///
+		/// Labels are only stamped from recordings made on the same page, so that
+		/// a page is drawn the same way whichever pages were drawn before it.
+		///
+		void PageRenderer::printPage( QPainter* painter, int iPage, Cursor& cursor ) const
+		{
+			cursor.stamps.clear();
+
 			if ( mModel )
 			{
 				if ( !mIsMerge )
 				{
-					printSimplePage( painter, iPage );
+					printSimplePage( painter, iPage, cursor );
 				}
 				else
 				{
 					if ( mIsCollated )
 					{
-						printCollatedMergePage( painter, iPage );
+						printCollatedMergePage( painter, iPage, cursor );
 					}
 					else
 					{
-						printUnCollatedMergePage( painter, iPage );
+						printUnCollatedMergePage( painter, iPage, cursor );
 					}
 				}
 			}
 		}
 
 
-		void PageRenderer::printSimplePage( QPainter* painter, int iPage ) const
+		void PageRenderer::printSimplePage( QPainter* painter, int iPage, Cursor& cursor ) const
 		{
 			printCropMarks( painter );
 
-			int iCopy = 0;
-			int iItem = mStartItem;
-			int iCurrentPage = 0;
-			mVariables->resetVariables();
-
-			while ( (iCopy < mNCopies) && (iCurrentPage <= iPage) )
+			while ( (cursor.iCopy < mNCopies) && (cursor.iPage <= iPage) )
 			{
-				if ( iCurrentPage == iPage )
+				if ( cursor.iPage == iPage )
 				{
-					int i = iItem % mNItemsPerPage;
-					
-					painter->save();
-
-					painter->translate( mOrigins[i].x().pt(), mOrigins[i].y().pt() );
-			
-					painter->save();
-
-					clipLabel( painter );
-					printLabel( painter, nullptr, mVariables );
-
-					painter->restore();  // From before clip
-
-					printOutline( painter );
-			
-					painter->restore();  // From before translation
+					printItem( painter, cursor, nullptr );
 				}
 
 				// Next copy
-				iCopy++;
-				iItem++;
-				iCurrentPage = iItem / mNItemsPerPage;
+				cursor.iCopy++;
+				cursor.iItem++;
+				cursor.iPage = cursor.iItem / mNItemsPerPage;
 
 				// User variable book keeping
-				mVariables->incrementVariablesOnItem();
-				mVariables->incrementVariablesOnCopy();
-				if ( (iItem % mNItemsPerPage) == 0 /* starting a new page */ )
+				cursor.variables->incrementVariablesOnItem();
+				cursor.variables->incrementVariablesOnCopy();
+				if ( (cursor.iItem % mNItemsPerPage) == 0 /* starting a new page */ )
 				{
-					mVariables->incrementVariablesOnPage();
+					cursor.variables->incrementVariablesOnPage();
 				}
 			}
 		}
 
 	
-		void PageRenderer::printCollatedMergePage( QPainter* painter, int iPage ) const
+		void PageRenderer::printCollatedMergePage( QPainter* painter, int iPage, Cursor& cursor ) const
 		{
 			printCropMarks( painter );
 
-			int iCopy = 0;
-			int iItem = mStartItem;
-			int iCurrentPage = 0;
-
-			const QList<merge::Record*> records = mMerge->selectedRecords();
-			int iRecord = 0;
-			int nRecords = records.size();
+			int nRecords = cursor.records.size();
 
 			if ( nRecords == 0 )
 			{
 				return;
 			}
 			
-			mVariables->resetVariables();
-
-			while ( (iCopy < mNCopies) && (iCurrentPage <= iPage) )
+			while ( (cursor.iCopy < mNCopies) && (cursor.iPage <= iPage) )
 			{
-				if ( iCurrentPage == iPage )
+				if ( cursor.iPage == iPage )
 				{
-					int i = iItem % mNItemsPerPage;
-					
-					painter->save();
-
-					painter->translate( mOrigins[i].x().pt(), mOrigins[i].y().pt() );
-			
-					painter->save();
-
-					clipLabel( painter );
-					printLabel( painter, records[iRecord], mVariables );
-
-					painter->restore();  // From before clip
-
-					printOutline( painter );
-			
-					painter->restore();  // From before translation
+					printItem( painter, cursor, cursor.records.at( cursor.iRecord ) );
 				}
 
 				// Next record
-				iRecord = (iRecord + 1) % nRecords;
-				if ( iRecord == 0 )
+				cursor.iRecord = (cursor.iRecord + 1) % nRecords;
+				if ( cursor.iRecord == 0 )
 				{
-					iCopy++;
+					cursor.iCopy++;
 					if ( mAreGroupsContiguous )
 					{
-						iItem++;
+						cursor.iItem++;
 					}
 					else
 					{
-						iItem = iCopy*mNPagesPerGroup*mNItemsPerPage + mStartItem;
+						cursor.iItem = cursor.iCopy*mNPagesPerGroup*mNItemsPerPage + mStartItem;
 					}
 				}
 				else
 				{
-					iItem++;
+					cursor.iItem++;
 				}
-				iCurrentPage = iItem / mNItemsPerPage;
+				cursor.iPage = cursor.iItem / mNItemsPerPage;
 
 				// User variable book keeping
-				mVariables->incrementVariablesOnItem();
-				if ( iRecord == 0 )
+				cursor.variables->incrementVariablesOnItem();
+				if ( cursor.iRecord == 0 )
 				{
-					mVariables->incrementVariablesOnCopy();
+					cursor.variables->incrementVariablesOnCopy();
 				}
-				if ( (iItem % mNItemsPerPage) == 0 /* starting a new page */ )
+				if ( (cursor.iItem % mNItemsPerPage) == 0 /* starting a new page */ )
 				{
-					mVariables->incrementVariablesOnPage();
+					cursor.variables->incrementVariablesOnPage();
 				}
 			}
 		}
 	
 	
-		void PageRenderer::printUnCollatedMergePage( QPainter* painter, int iPage ) const
+		void PageRenderer::printUnCollatedMergePage( QPainter* painter, int iPage, Cursor& cursor ) const
 		{
 			printCropMarks( painter );
 
-			int iCopy = 0;
-			int iItem = mStartItem;
-			int iCurrentPage = 0;
-
-			const QList<merge::Record*> records = mMerge->selectedRecords();
-			int iRecord = 0;
-			int nRecords = records.size();
+			int nRecords = cursor.records.size();
 
 			if ( nRecords == 0 )
 			{
 				return;
 			}
 			
-			mVariables->resetVariables();
-
-			while ( (iRecord < nRecords) && (iCurrentPage <= iPage) )
+			while ( (cursor.iRecord < nRecords) && (cursor.iPage <= iPage) )
 			{
-				if ( iCurrentPage == iPage )
+				if ( cursor.iPage == iPage )
 				{
-					int i = iItem % mNItemsPerPage;
-					
-					painter->save();
-
-					painter->translate( mOrigins[i].x().pt(), mOrigins[i].y().pt() );
-			
-					painter->save();
-
-					clipLabel( painter );
-					printLabel( painter, records[iRecord], mVariables );
-
-					painter->restore();  // From before clip
-
-					printOutline( painter );
-			
-					painter->restore();  // From before translation
+					printItem( painter, cursor, cursor.records.at( cursor.iRecord ) );
 				}
 
 				// Next copy
-				iCopy = (iCopy + 1) % mNCopies;
-				if ( iCopy == 0 )
+				cursor.iCopy = (cursor.iCopy + 1) % mNCopies;
+				if ( cursor.iCopy == 0 )
 				{
-					iRecord++;
+					cursor.iRecord++;
 					if ( mAreGroupsContiguous )
 					{
-						iItem++;
+						cursor.iItem++;
 					}
 					else
 					{
-						iItem = iRecord*mNPagesPerGroup*mNItemsPerPage + mStartItem;
+						cursor.iItem = cursor.iRecord*mNPagesPerGroup*mNItemsPerPage + mStartItem;
 					}
 				}
 				else
 				{
-					iItem++;
+					cursor.iItem++;
 				}
-				iCurrentPage = iItem / mNItemsPerPage;
+				cursor.iPage = cursor.iItem / mNItemsPerPage;
 
 				// User variable book keeping
-				mVariables->incrementVariablesOnItem();
-				mVariables->incrementVariablesOnCopy();
-				if ( iCopy == 0 )
+				cursor.variables->incrementVariablesOnItem();
+				cursor.variables->incrementVariablesOnCopy();
+				if ( cursor.iCopy == 0 )
 				{
-					mVariables->resetOnCopyVariables();
+					cursor.variables->resetOnCopyVariables();
 				}
-				if ( (iItem % mNItemsPerPage) == 0 /* starting a new page */ )
+				if ( (cursor.iItem % mNItemsPerPage) == 0 /* starting a new page */ )
 				{
-					mVariables->incrementVariablesOnPage();
+					cursor.variables->incrementVariablesOnPage();
 				}
 			}
 		}
+
+
+		void PageRenderer::printItem( QPainter*      painter,
+		                              Cursor&        cursor,
+		                              merge::Record* record ) const
+		{
+			int i = cursor.iItem % mNItemsPerPage;
+
+			painter->save();
+
+			painter->translate( mOrigins[i].x().pt(), mOrigins[i].y().pt() );
+
+			painter->save();
+
+			clipLabel( painter );
+			printStampedLabel( painter, cursor, record );
+
+			painter->restore();  // From before clip
+
+			printOutline( painter );
+
+			painter->restore();  // From before translation
+		}
+
+
+		void PageRenderer::printLabelItem( QPainter* painter, Cursor& cursor ) const
+		{
+			merge::Record* record = nullptr;
+			if ( mIsMerge )
+			{
+				record = cursor.records.at( cursor.iRecord );
+				if ( !record )
+				{
+					return;
+				}
+			}
+
+			painter->save();
+
+			clipLabel( painter );
+			printLabel( painter, cursor.model, record, cursor.variables );
+
+			painter->restore();  // From before clip
+
+			printOutline( painter );
+		}
 	
 	
 		void PageRenderer::printCropMarks( QPainter* painter ) const
@@ -574,6 +1460,7 @@ namespace glabels
 
 	
 		void PageRenderer::printLabel( QPainter*      painter,
+		                               const Model*   model,
 		                               merge::Record* record,
 		                               Variables*     variables ) const
 		{
@@ -591,10 +1478,81 @@ namespace glabels
 				painter->scale( -1, 1 );
 			}
 
-			mModel->draw( painter, false, record, variables );
+			model->draw( painter, false, record, variables );
 
 			painter->restore();
 		}
 
+
+		///
+		/// Print label, stamping a recording of any identical label printed before
+		///
+		/// Labels are identical if they have the same values of all fields and
+		/// variables referenced by the model, e.g. copies of a record, or all items
+		/// of a simple project.  Recording a label and replaying the recording costs
+		/// somewhat more than drawing it directly, while replaying it again costs
+		/// far less, as no fields are evaluated and no text or barcodes are laid
+		/// out.  So a label is drawn directly the first time it is seen, recorded
+		/// the second time, and stamped from then on: labels that never repeat cost
+		/// no more than before, and the recording pays for itself from the third
+		/// use on.  The recordings of the least recently used labels are dropped.
+		///
+		void PageRenderer::printStampedLabel( QPainter* painter, Cursor& cursor, merge::Record* record ) const
+		{
+			if ( !cursor.canStamp )
+			{
+				printLabel( painter, cursor.model, record, cursor.variables );
+				return;
+			}
+
+			QString key = labelKey( cursor, record );
+
+			Stamp* stamp = cursor.stamps.object( key );
+			if ( !stamp )
+			{
+				stamp = new Stamp;
+				stamp->nUses = 0;
+				cursor.stamps.insert( key, stamp );
+			}
+			stamp->nUses++;
+
+			if ( stamp->nUses == 1 )
+			{
+				printLabel( painter, cursor.model, record, cursor.variables );
+				return;
+			}
+
+			if ( stamp->nUses == 2 )
+			{
+				QPainter recorder( &stamp->picture );
+				printLabel( &recorder, cursor.model, record, cursor.variables );
+			}
+
+			painter->drawPicture( 0, 0, stamp->picture );
+		}
+
+
+		///
+		/// Key of label content, from the values of all fields referenced by the model
+		///
+		QString PageRenderer::labelKey( const Cursor& cursor, const merge::Record* record )
+		{
+			QString key;
+
+			foreach ( const QString& name, cursor.fieldNames )
+			{
+				QString recordValue = record ? record->value( name ) : QString();
+
+				const Variable* variable = cursor.variables->variable( name );
+				QString variableValue = variable ? variable->value() : QString();
+
+				// Length prefixed, so that no two different sets of values have the same key
+				key += QString::number( recordValue.size() ) + ':' + recordValue;
+				key += QString::number( variableValue.size() ) + ':' + variableValue;
+			}
+
+			return key;
+		}
+
 	}
 }
@@ -27,10 +27,17 @@
 
 #include "merge/Merge.h"
 #include "merge/Record.h"
+#include "merge/RecordCursor.h"
 
+#include <QByteArray>
+#include <QCache>
+#include <QDataStream>
 #include <QPainter>
+#include <QPicture>
 #include <QPrinter>
 #include <QRect>
+#include <QString>
+#include <QStringList>
 #include <QVector>
 
 
@@ -71,12 +78,23 @@ namespace glabels
 			void setPrintCropMarks( bool printCropMarksFlag );
 			void setPrintReverse( bool printReverseFlag );
 			void setIPage( int iPage );
+			void setPrintRange( int iFirstPage, int nPages );
 			int nItems() const;
 			int nPages() const;
 			QRectF pageRect() const;
-			void print( QPrinter* printer ) const;
+			void print( QPrinter* printer, int nJobs = 1 ) const;
 			void printPage( QPainter* painter ) const;
 			void printPage( QPainter* painter, int iPage ) const;
+			void printPage( QPainter* painter, int iPage, Variables* variables ) const;
+			void printItem( QPainter* painter, int iItem, Variables* variables ) const;
+			bool printImages( const QString&    fileNameTemplate,
+			                  const QByteArray& format,
+			                  double            dpi,
+			                  bool              perLabel,
+			                  int               nJobs = 1 ) const;
+			bool printPictures( const QString& fileName, int nJobs = 1 ) const;
+
+			static bool printPictureFiles( QPrinter* printer, const QStringList& fileNames );
 
 
 			/////////////////////////////////
@@ -93,18 +111,71 @@ namespace glabels
 			void onModelChanged();
 
 
+			/////////////////////////////////
+			// Render Cursor
+			/////////////////////////////////
+		private:
+			struct Stamp
+			{
+				int                   nUses;
+				QPicture              picture;      // Recorded on second use
+			};
+
+			struct Cursor
+			{
+				const Model*          model;
+				int                   iCopy;
+				int                   iItem;
+				int                   iRecord;
+				int                   iPage;
+				merge::RecordCursor   records;
+				Variables*            variables;
+
+				QStringList           fieldNames;   // Referenced by model
+				bool                  canStamp;     // Can labels repeat?
+				QCache<QString,Stamp> stamps;       // By label content, for current page
+			};
+
+
+			class PageRecorder;
+			class ImageWriter;
+
+
 			/////////////////////////////////
 			// Internal Methods
 			/////////////////////////////////
 		private:
 			void updateNPages();
-			void printSimplePage( QPainter* painter, int iPage ) const;
-			void printCollatedMergePage( QPainter* painter, int iPage ) const;
-			void printUnCollatedMergePage( QPainter* painter, int iPage ) const;
+			void printRange( int& iFirstPage, int& nPages ) const;
+			void printPages( QPrinter* printer, QPainter* painter, QDataStream* stream, int nJobs ) const;
+			void printParallel( QPrinter* printer, QPainter* painter, QDataStream* stream, int nJobs ) const;
+			void recordPage( QPicture* picture, int iPage, Cursor& cursor ) const;
+			static void outputPage( QPrinter*       printer,
+			                        QPainter*       painter,
+			                        QDataStream*    stream,
+			                        const QPicture& picture,
+			                        bool            isFirstPage );
+			bool arePagesRepeated() const;
+			bool isFullPage( int iPage ) const;
+			static void beginPrint( QPrinter* printer, QPainter* painter, const QSizeF& pageSize );
+			void initCursor( Cursor& cursor, const Model* model, Variables* variables ) const;
+			merge::Merge* loadJobRecords() const;
+			int firstItemOnPage( int iPage ) const;
+			void seekCursor( Cursor& cursor, int iPage ) const;
+			void seekCursorToItem( Cursor& cursor, int k ) const;
+			void groupSize( const Cursor& cursor, int& nGroups, int& nItemsPerGroup ) const;
+			void printPage( QPainter* painter, int iPage, Cursor& cursor ) const;
+			void printSimplePage( QPainter* painter, int iPage, Cursor& cursor ) const;
+			void printCollatedMergePage( QPainter* painter, int iPage, Cursor& cursor ) const;
+			void printUnCollatedMergePage( QPainter* painter, int iPage, Cursor& cursor ) const;
+			void printItem( QPainter* painter, Cursor& cursor, merge::Record* record ) const;
+			void printLabelItem( QPainter* painter, Cursor& cursor ) const;
 			void printCropMarks( QPainter* painter ) const;
 			void printOutline( QPainter* painter ) const;
 			void clipLabel( QPainter* painter ) const;
-			void printLabel( QPainter* painter, merge::Record* record, Variables* variables ) const;
+			void printLabel( QPainter* painter, const Model* model, merge::Record* record, Variables* variables ) const;
+			void printStampedLabel( QPainter* painter, Cursor& cursor, merge::Record* record ) const;
+			static QString labelKey( const Cursor& cursor, const merge::Record* record );
 
 
 			/////////////////////////////////
@@ -122,6 +193,8 @@ namespace glabels
 			int               mNItemsPerGroup;
 			int               mNPagesPerGroup;
 			int               mIPage;
+			int               mPrintFirstPage;
+			int               mPrintNPages;
 
 			bool              mIsMerge;
 
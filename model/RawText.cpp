@@ -20,17 +20,26 @@
 
 #include "RawText.h"
 
-#include <QRegularExpression>
-
 namespace glabels
 {
 	namespace model
 	{
 
+		///
+		/// Default constructor
+		///
+		RawText::RawText()
+			: mNFieldTokens(0), mBoundSchemaSize(0), mBoundVariables(nullptr), mBoundVariablesVersion(-1)
+		{
+		}
+
+
 		///
 		/// Constructor from QString
 		///
-		RawText::RawText( const QString& string ) : mString(string)
+		RawText::RawText( const QString& string )
+			: mString(string), mNFieldTokens(0),
+			  mBoundSchemaSize(0), mBoundVariables(nullptr), mBoundVariablesVersion(-1)
 		{
 			tokenize();
 		}
@@ -39,7 +48,9 @@ namespace glabels
 		///
 		/// Constructor from C string operator
 		///
-		RawText::RawText( const char* cString ) : mString(QString(cString))
+		RawText::RawText( const char* cString )
+			: mString(QString(cString)), mNFieldTokens(0),
+			  mBoundSchemaSize(0), mBoundVariables(nullptr), mBoundVariablesVersion(-1)
 		{
 			tokenize();
 		}
@@ -66,33 +77,68 @@ namespace glabels
 		///
 		/// Expand all place holders
 		///
+		/// Fields are looked up by index, as bound to the schema of record and to
+		/// variables, and the text is built in a buffer reused between calls.
+		///
 		QString RawText::expand( merge::Record* record, Variables* variables ) const
 		{
-			QString text;
-		
+			if ( mNFieldTokens == 0 )
+			{
+				return mString;
+			}
+
+			bind( record, variables );
+
+			mBuffer.resize( 0 );
+
+			int iFieldToken = 0;
 			foreach ( const Token& token, mTokens )
 			{
 				if ( token.isField )
 				{
-					text += token.field.evaluate( record, variables );
+					mBuffer += token.field.evaluate( record,
+					                                 mFieldIndexes[iFieldToken],
+					                                 mFieldVariables[iFieldToken] );
+					iFieldToken++;
 				}
 				else
 				{
-					text += token.text;
+					mBuffer += token.text;
 				}
 			}
 
-			return text;
+			return mBuffer;
 		}
 
 
 		///
 		/// Does raw text contain place holders?
 		///
+		/// Any substitution field counts, whether or not it has a default value
+		/// or format.
+		///
 		bool RawText::hasPlaceHolders() const
 		{
-			QRegularExpression re("\\${\\w+}");
-			return mString.contains( re );
+			return mNFieldTokens != 0;
+		}
+
+
+		///
+		/// Names of fields referenced by place holders
+		///
+		QStringList RawText::fieldNames() const
+		{
+			QStringList names;
+
+			foreach ( const Token& token, mTokens )
+			{
+				if ( token.isField && !names.contains( token.field.fieldName() ) )
+				{
+					names << token.field.fieldName();
+				}
+			}
+
+			return names;
 		}
 
 
@@ -144,7 +190,54 @@ namespace glabels
 				token.isField = false;
 				mTokens.append( token );
 			}
-				
+
+			mNFieldTokens = 0;
+			foreach ( const Token& token, mTokens )
+			{
+				if ( token.isField )
+				{
+					mNFieldTokens++;
+				}
+			}
+		}
+
+
+		///
+		/// Bind field tokens to schema of record and to variables
+		///
+		/// Each field token is resolved to its field index in the schema, and to
+		/// the variable of the same name, once for as long as the schema (which
+		/// only ever grows) has the same size and the variables the same version.
+		///
+		void RawText::bind( const merge::Record* record, const Variables* variables ) const
+		{
+			const merge::Schema* schema = record ? record->schema().data() : nullptr;
+			int schemaSize       = schema ? schema->size() : 0;
+			int variablesVersion = variables ? variables->version() : 0;
+
+			if ( (schema == mBoundSchema.data()) && (schemaSize == mBoundSchemaSize) &&
+			     (variables == mBoundVariables) && (variablesVersion == mBoundVariablesVersion) )
+			{
+				return;
+			}
+
+			// Hold on to schema, so that it cannot be mistaken for a new one
+			mBoundSchema           = record ? record->schema() : QSharedPointer<merge::Schema>();
+			mBoundSchemaSize       = schemaSize;
+			mBoundVariables        = variables;
+			mBoundVariablesVersion = variablesVersion;
+
+			mFieldIndexes.clear();
+			mFieldVariables.clear();
+			foreach ( const Token& token, mTokens )
+			{
+				if ( token.isField )
+				{
+					QString name = token.field.fieldName();
+					mFieldIndexes   << (schema ? schema->indexOf( name ) : -1);
+					mFieldVariables << (variables ? variables->variable( name ) : nullptr);
+				}
+			}
 		}
 
 	
@@ -24,7 +24,12 @@
 
 #include "SubstitutionField.h"
 
+#include "merge/Schema.h"
+
+#include <QSharedPointer>
 #include <QString>
+#include <QStringList>
+#include <QVector>
 
 
 namespace glabels
@@ -42,7 +47,7 @@ namespace glabels
 			// Life Cycle
 			/////////////////////////////////
 		public:
-			RawText() = default;
+			RawText();
 			RawText( const QString& string );
 			RawText( const char* cString );
 
@@ -54,6 +59,7 @@ namespace glabels
 			std::string toStdString() const;
 			QString expand( merge::Record* record, Variables* variables ) const;
 			bool hasPlaceHolders() const;
+			QStringList fieldNames() const;
 			bool isEmpty() const;
 
 		
@@ -62,6 +68,7 @@ namespace glabels
 			/////////////////////////////////
 		private:
 			void tokenize();
+			void bind( const merge::Record* record, const Variables* variables ) const;
 		
 			/////////////////////////////////
 			// Private Data
@@ -77,6 +84,17 @@ namespace glabels
 			};
 		
 			QList<Token> mTokens;
+			int          mNFieldTokens;
+
+			// Field tokens bound to schema and variables, see bind()
+			mutable QSharedPointer<merge::Schema> mBoundSchema;
+			mutable int                           mBoundSchemaSize;
+			mutable const Variables*              mBoundVariables;
+			mutable int                           mBoundVariablesVersion;
+			mutable QVector<int>                  mFieldIndexes;
+			mutable QVector<const Variable*>      mFieldVariables;
+
+			mutable QString                       mBuffer;  // Reused by expand()
 
 		};
 
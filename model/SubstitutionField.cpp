@@ -29,13 +29,19 @@ namespace glabels
 	{
 
 		SubstitutionField::SubstitutionField()
-			: mFormatType(0), mNewLine(false)
+			: mFormatType(0),
+			  mFormatLeftAlign(false), mFormatPlusSign(false), mFormatSpaceSign(false), mFormatZeroPad(false),
+			  mFormatWidth(0), mFormatPrecision(-1),
+			  mNewLine(false)
 		{
 		}
 
 
 		SubstitutionField::SubstitutionField( const QString& string )
-			: mFormatType(0), mNewLine(false)
+			: mFormatType(0),
+			  mFormatLeftAlign(false), mFormatPlusSign(false), mFormatSpaceSign(false), mFormatZeroPad(false),
+			  mFormatWidth(0), mFormatPrecision(-1),
+			  mNewLine(false)
 		{
 			QStringRef s(&string);
 			parse( s, *this );
@@ -44,23 +50,42 @@ namespace glabels
 
 		QString SubstitutionField::evaluate( const merge::Record* record,
 		                                     const Variables* variables ) const
+		{
+			int iField = record ? record->schema()->indexOf( mFieldName ) : -1;
+			const Variable* variable = variables ? variables->variable( mFieldName ) : nullptr;
+
+			return evaluate( record, iField, variable );
+		}
+
+
+		QString SubstitutionField::evaluate( const merge::Record* record,
+		                                     int                  iField,
+		                                     const Variable*      variable ) const
 		{
 			QString value = mDefaultValue;
 
-			bool haveRecordField = record &&
-				record->contains(mFieldName) &&
-				!record->value(mFieldName).isEmpty();
-			bool haveVariable = variables &&
-				variables->contains(mFieldName) &&
-				!(*variables)[mFieldName].value().isEmpty();
+			QString recordValue;
+			if ( record && (iField >= 0) && (iField < record->nFields()) )
+			{
+				recordValue = record->field( iField );
+			}
+
+			QString variableValue;
+			if ( recordValue.isEmpty() && variable )
+			{
+				variableValue = variable->value();
+			}
+
+			bool haveRecordField = !recordValue.isEmpty();
+			bool haveVariable    = !variableValue.isEmpty();
 
 			if ( haveRecordField )
 			{
-				value = record->value(mFieldName);
+				value = recordValue;
 			}
 			else if ( haveVariable )
 			{
-				value = (*variables)[mFieldName].value();
+				value = variableValue;
 			}
 
 			if ( !mFormatType.isNull() )
@@ -223,6 +248,8 @@ namespace glabels
 
 			parseFormatType( s, field );
 
+			compileFormat( field );
+
 			return true; // Don't let invalid formats kill entire SubstitutionField
 		}
 
@@ -295,6 +322,47 @@ namespace glabels
 			return true;
 		}
 
+
+		void SubstitutionField::compileFormat( SubstitutionField& field )
+		{
+			field.mFormatLeftAlign = false;
+			field.mFormatPlusSign  = false;
+			field.mFormatSpaceSign = false;
+			field.mFormatZeroPad   = false;
+			field.mFormatWidth     = 0;
+			field.mFormatPrecision = -1;
+			field.mFormatBytes     = field.mFormat.toLatin1();
+
+			// Format has already been validated by parser: %[flags][width][.prec]type
+			QStringRef s( &field.mFormat );
+			s = s.mid(1);
+
+			for ( ; s.size() && QString( "-+ 0" ).contains( s[0] ); s = s.mid(1) )
+			{
+				switch ( s[0].unicode() )
+				{
+				case '-': field.mFormatLeftAlign = true; break;
+				case '+': field.mFormatPlusSign  = true; break;
+				case ' ': field.mFormatSpaceSign = true; break;
+				case '0': field.mFormatZeroPad   = true; break;
+				}
+			}
+
+			for ( ; s.size() && s[0].isDigit(); s = s.mid(1) )
+			{
+				field.mFormatWidth = 10*field.mFormatWidth + s[0].digitValue();
+			}
+
+			if ( s.size() && s[0] == '.' )
+			{
+				field.mFormatPrecision = 0;
+				for ( s = s.mid(1); s.size() && s[0].isDigit(); s = s.mid(1) )
+				{
+					field.mFormatPrecision = 10*field.mFormatPrecision + s[0].digitValue();
+				}
+			}
+		}
+
 	
 		QString SubstitutionField::formatValue( const QString& value ) const
 		{
@@ -303,8 +371,11 @@ namespace glabels
 				
 			case 'd':
 			case 'i':
-				return QString::asprintf( mFormat.toStdString().c_str(),
-				                          value.toLongLong(nullptr,0) );
+				{
+					qlonglong n = value.toLongLong(nullptr,0);
+					qulonglong magnitude = (n < 0) ? (0 - qulonglong(n)) : qulonglong(n);
+					return formatInteger( magnitude, n < 0, true );
+				}
 				break;
 				
 
@@ -312,8 +383,7 @@ namespace glabels
 			case 'x':
 			case 'X':
 			case 'o':
-				return QString::asprintf( mFormat.toStdString().c_str(),
-				                          value.toULongLong(nullptr,0) );
+				return formatInteger( value.toULongLong(nullptr,0), false, false );
 				break;
 
 			case 'f':
@@ -322,13 +392,11 @@ namespace glabels
 			case 'E':
 			case 'g':
 			case 'G':
-				return QString::asprintf( mFormat.toStdString().c_str(),
-				                          value.toDouble() );
+				return QString::asprintf( mFormatBytes.constData(), value.toDouble() );
 				break;
 
 			case 's':
-				return QString::asprintf( mFormat.toStdString().c_str(),
-				                          value.toStdString().c_str() );
+				return formatString( value );
 				break;
 
 			default:
@@ -338,7 +406,108 @@ namespace glabels
 
 			}
 		}
-	
+
+
+
+		QString SubstitutionField::formatInteger( qulonglong magnitude, bool isNegative, bool isSigned ) const
+		{
+			int base = 10;
+			switch (mFormatType.unicode())
+			{
+			case 'x':
+			case 'X':
+				base = 16;
+				break;
+			case 'o':
+				base = 8;
+				break;
+			}
+
+			// Digits, zero extended to precision.  Precision 0 prints nothing for 0.
+			QString digits;
+			if ( (magnitude != 0) || (mFormatPrecision != 0) )
+			{
+				digits = QString::number( magnitude, base );
+				if ( mFormatType == 'X' )
+				{
+					digits = digits.toUpper();
+				}
+			}
+
+			QChar sign;
+			if ( isSigned )
+			{
+				if ( isNegative )
+				{
+					sign = '-';
+				}
+				else if ( mFormatPlusSign )
+				{
+					sign = '+';
+				}
+				else if ( mFormatSpaceSign )
+				{
+					sign = ' ';
+				}
+			}
+
+			int nZeros = qMax( mFormatPrecision - digits.size(), 0 );
+			int nChars = (sign.isNull() ? 0 : 1) + nZeros + digits.size();
+			int nPad   = qMax( mFormatWidth - nChars, 0 );
+
+			QString text;
+			text.reserve( nChars + nPad );
+
+			bool padWithZeros = mFormatZeroPad && !mFormatLeftAlign && (mFormatPrecision < 0);
+			if ( !mFormatLeftAlign && !padWithZeros )
+			{
+				text.fill( ' ', nPad );
+			}
+			if ( !sign.isNull() )
+			{
+				text += sign;
+			}
+			if ( padWithZeros )
+			{
+				nZeros += nPad;
+			}
+			for ( int i = 0; i < nZeros; i++ )
+			{
+				text += QChar('0');
+			}
+			text += digits;
+			if ( mFormatLeftAlign )
+			{
+				for ( int i = 0; i < nPad; i++ )
+				{
+					text += QChar(' ');
+				}
+			}
+
+			return text;
+		}
+
+
+		QString SubstitutionField::formatString( const QString& value ) const
+		{
+			QString text = (mFormatPrecision >= 0) ? value.left( mFormatPrecision ) : value;
+
+			int nPad = mFormatWidth - text.size();
+			if ( nPad > 0 )
+			{
+				if ( mFormatLeftAlign )
+				{
+					text.append( QString( nPad, ' ' ) );
+				}
+				else
+				{
+					text.prepend( QString( nPad, ' ' ) );
+				}
+			}
+
+			return text;
+		}
+
 
 	}
 }
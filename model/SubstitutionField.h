@@ -25,6 +25,7 @@
 
 #include "merge/Record.h"
 
+#include <QByteArray>
 #include <QString>
 #include <QStringRef>
 
@@ -41,6 +42,7 @@ namespace glabels
 			SubstitutionField( const QString& string );
 
 			QString evaluate( const merge::Record* record, const Variables* variables ) const;
+			QString evaluate( const merge::Record* record, int iField, const Variable* variable ) const;
 		
 			QString fieldName() const;
 			QString defaultValue() const;
@@ -61,8 +63,11 @@ namespace glabels
 			static bool parseFormatType( QStringRef& s, SubstitutionField& field );
 			static bool parseNaturalInteger( QStringRef& s, SubstitutionField& field );
 			static bool parseNewLineModifier( QStringRef& s, SubstitutionField& field );
+			static void compileFormat( SubstitutionField& field );
 
 			QString formatValue( const QString& value ) const;
+			QString formatInteger( qulonglong magnitude, bool isNegative, bool isSigned ) const;
+			QString formatString( const QString& value ) const;
 
 			QString mFieldName;
 
@@ -71,6 +76,15 @@ namespace glabels
 			QString mFormat;
 			QChar   mFormatType;
 
+			// Format, as parsed once by compileFormat()
+			bool       mFormatLeftAlign;
+			bool       mFormatPlusSign;
+			bool       mFormatSpaceSign;
+			bool       mFormatZeroPad;
+			int        mFormatWidth;
+			int        mFormatPrecision;  // -1 if none
+			QByteArray mFormatBytes;      // For floating point values
+
 			bool    mNewLine;
 		};
 
@@ -110,16 +110,16 @@ namespace glabels
 		{
 			QString value("");
 			
-			bool haveRecordField = mIsField && record &&
-				record->contains(mData) &&
-				!record->value(mData).isEmpty();
+			QString recordValue = (mIsField && record) ? record->value(mData) : QString();
+
+			bool haveRecordField = !recordValue.isEmpty();
 			bool haveVariable = mIsField && variables &&
 				variables->contains(mData) &&
 				!(*variables)[mData].value().isEmpty();
 
 			if ( haveRecordField )
 			{
-				value = record->value(mData);
+				value = recordValue;
 			}
 			else if ( haveVariable )
 			{
@@ -30,8 +30,10 @@ namespace glabels
 			: mType(Type::STRING),
 			  mIncrement(Increment::NEVER),
 			  mStepSize("0"),
+			  mNSteps(0),
 			  mIntegerValue(0),
 			  mIntegerStep(0),
+			  mFloatingPointInitialValue(0),
 			  mFloatingPointValue(0),
 			  mFloatingPointStep(0)
 		{
@@ -49,8 +51,10 @@ namespace glabels
 			  mInitialValue(initialValue),
 			  mIncrement(increment),
 			  mStepSize(stepSize),
+			  mNSteps(0),
 			  mIntegerValue(0),
 			  mIntegerStep(0),
+			  mFloatingPointInitialValue(0),
 			  mFloatingPointValue(0),
 			  mFloatingPointStep(0)
 		{
@@ -96,23 +100,7 @@ namespace glabels
 
 		void    Variable::resetValue()
 		{
-			switch (mType)
-			{
-			case Type::STRING:
-				// do nothing
-				break;
-			case Type::INTEGER:
-				mIntegerValue = mInitialValue.toLongLong();
-				mIntegerStep  = mStepSize.toLongLong();
-				break;
-			case Type::FLOATING_POINT:
-				mFloatingPointValue = mInitialValue.toDouble();
-				mFloatingPointStep  = mStepSize.toDouble();
-				break;
-			case Type::COLOR:
-				// do nothing
-				break;
-			}
+			setValueAt( 0, 0, 0 );
 		}
 
 		
@@ -120,21 +108,7 @@ namespace glabels
 		{
 			if ( mIncrement == Increment::PER_ITEM )
 			{
-				switch (mType)
-				{
-				case Type::STRING:
-					// do nothing
-					break;
-				case Type::INTEGER:
-					mIntegerValue += mIntegerStep;
-					break;
-				case Type::FLOATING_POINT:
-					mFloatingPointValue += mFloatingPointStep;
-					break;
-				case Type::COLOR:
-					// do nothing
-					break;
-				}
+				stepValue();
 			}
 		}
 
@@ -143,21 +117,7 @@ namespace glabels
 		{
 			if ( mIncrement == Increment::PER_COPY )
 			{
-				switch (mType)
-				{
-				case Type::STRING:
-					// do nothing
-					break;
-				case Type::INTEGER:
-					mIntegerValue += mIntegerStep;
-					break;
-				case Type::FLOATING_POINT:
-					mFloatingPointValue += mFloatingPointStep;
-					break;
-				case Type::COLOR:
-					// do nothing
-					break;
-				}
+				stepValue();
 			}
 		}
 
@@ -166,21 +126,78 @@ namespace glabels
 		{
 			if ( mIncrement == Increment::PER_PAGE )
 			{
-				switch (mType)
-				{
-				case Type::STRING:
-					// do nothing
-					break;
-				case Type::INTEGER:
-					mIntegerValue += mIntegerStep;
-					break;
-				case Type::FLOATING_POINT:
-					mFloatingPointValue += mFloatingPointStep;
-					break;
-				case Type::COLOR:
-					// do nothing
-					break;
-				}
+				stepValue();
+			}
+		}
+
+
+		///
+		/// Set value directly to what it would be after nItems, nCopies and nPages
+		/// increments since the last reset, without replaying each increment.
+		///
+		void    Variable::setValueAt( long long nItems, long long nCopies, long long nPages )
+		{
+			switch (mIncrement)
+			{
+			case Increment::NEVER:
+				mNSteps = 0;
+				break;
+			case Increment::PER_ITEM:
+				mNSteps = nItems;
+				break;
+			case Increment::PER_COPY:
+				mNSteps = nCopies;
+				break;
+			case Increment::PER_PAGE:
+				mNSteps = nPages;
+				break;
+			}
+
+			switch (mType)
+			{
+			case Type::STRING:
+				// do nothing
+				break;
+			case Type::INTEGER:
+				mIntegerStep  = mStepSize.toLongLong();
+				mIntegerValue = mInitialValue.toLongLong() + mNSteps*mIntegerStep;
+				break;
+			case Type::FLOATING_POINT:
+				mFloatingPointInitialValue = mInitialValue.toDouble();
+				mFloatingPointStep         = mStepSize.toDouble();
+				mFloatingPointValue        = mFloatingPointInitialValue + mNSteps*mFloatingPointStep;
+				break;
+			case Type::COLOR:
+				// do nothing
+				break;
+			}
+		}
+
+
+		///
+		/// Advance value by one step
+		///
+		/// Floating point values are recomputed from the step count rather than
+		/// accumulated, so that they match setValueAt() exactly.
+		///
+		void    Variable::stepValue()
+		{
+			mNSteps++;
+
+			switch (mType)
+			{
+			case Type::STRING:
+				// do nothing
+				break;
+			case Type::INTEGER:
+				mIntegerValue += mIntegerStep;
+				break;
+			case Type::FLOATING_POINT:
+				mFloatingPointValue = mFloatingPointInitialValue + mNSteps*mFloatingPointStep;
+				break;
+			case Type::COLOR:
+				// do nothing
+				break;
 			}
 		}
 
@@ -77,6 +77,7 @@ namespace glabels
 			void    incrementValueOnItem();
 			void    incrementValueOnCopy();
 			void    incrementValueOnPage();
+			void    setValueAt( long long nItems, long long nCopies, long long nPages );
 			QString value() const;
 
 			static QString   typeToI18nString( Type type );
@@ -88,6 +89,10 @@ namespace glabels
 			static Increment idStringToIncrement( const QString& string );
 
 
+		private:
+			void      stepValue();
+
+
 		private:
 			Type      mType;
 			QString   mName;
@@ -95,8 +100,10 @@ namespace glabels
 			Increment mIncrement;
 			QString   mStepSize;
 
+			long long mNSteps;
 			long long mIntegerValue;
 			long long mIntegerStep;
+			double    mFloatingPointInitialValue;
 			double    mFloatingPointValue;
 			double    mFloatingPointStep;
 
@@ -20,6 +20,7 @@
 
 #include "Variables.h"
 
+#include <QAtomicInt>
 #include <QtDebug>
 
 
@@ -27,12 +28,43 @@ namespace glabels
 {
 	namespace model
 	{
+
+		//
+		// Private
+		//
+		namespace
+		{
+			QAtomicInt lastVersion( 0 );
+
+			///
+			/// New version number, distinct from that of any variables object
+			///
+			int newVersion()
+			{
+				return lastVersion.fetchAndAddRelaxed( 1 ) + 1;
+			}
+		}
+
+
+		///
+		/// Default constructor
+		///
+		Variables::Variables()
+			: mVersion(newVersion())
+		{
+		}
+
+
 		///
 		/// Copy constructor
 		///
+		/// The copy does not share its data with the original, so that pointers
+		/// returned by variable() stay valid until the next new version.
+		///
 		Variables::Variables( const Variables* variables )
-			: QMap<QString,Variable>(*variables)
+			: QMap<QString,Variable>(*variables), mVersion(newVersion())
 		{
+			detach();
 		}
 
 
@@ -54,12 +86,39 @@ namespace glabels
 		}
 
 
+		///
+		/// Get variable by name, or nullptr if none
+		///
+		/// The pointer is valid as long as version() is unchanged.
+		///
+		const Variable* Variables::variable( const QString& name ) const
+		{
+			auto i = constFind( name );
+			return (i != constEnd()) ? &i.value() : nullptr;
+		}
+
+
+		///
+		/// Get version of set of variables
+		///
+		/// A new version is taken whenever variables are added, deleted or
+		/// replaced, but not when their values change.  Versions are distinct
+		/// between variables objects, so that variables looked up by name can be
+		/// safely reused while the version of their variables object is unchanged.
+		///
+		int Variables::version() const
+		{
+			return mVersion;
+		}
+
+
 		///
 		/// Add variable ( will replace if name is the same )
 		///
 		void Variables::addVariable( const Variable& variable )
 		{
 			insert( variable.name(), variable );
+			mVersion = newVersion();
 			emit changed();
 		}
 
@@ -70,6 +129,7 @@ namespace glabels
 		void Variables::deleteVariable( const QString& name )
 		{
 			remove( name );
+			mVersion = newVersion();
 			emit changed();
 		}
 
@@ -81,6 +141,7 @@ namespace glabels
 		{
 			remove( origName );
 			insert( variable.name(), variable );
+			mVersion = newVersion();
 			emit changed();
 		}
 
@@ -169,6 +230,19 @@ namespace glabels
 		}
 
 
+		///
+		/// Set variables to their values after the given number of item, copy
+		/// and page increments since reset
+		///
+		void Variables::setVariablesAt( long long nItems, long long nCopies, long long nPages )
+		{
+			for ( auto& v : *this )
+			{
+				v.setValueAt( nItems, nCopies, nPages );
+			}
+		}
+
+
 	} // namespace model
 
 } // namespace glabels
@@ -45,7 +45,7 @@ namespace glabels
 			// Life Cycle
 			/////////////////////////////////
 		public:
-			Variables() = default;
+			Variables();
 			Variables( const Variables* variables );
 
 
@@ -59,6 +59,8 @@ namespace glabels
 			// Methods
 			/////////////////////////////////
 			bool hasVariable( const QString& name ) const;
+			const Variable* variable( const QString& name ) const;
+			int version() const;
 			void addVariable( const Variable& variable );
 			void deleteVariable( const QString& name );
 			void replaceVariable( const QString& name, const Variable& variable );
@@ -70,6 +72,7 @@ namespace glabels
 			void incrementVariablesOnItem();
 			void incrementVariablesOnCopy();
 			void incrementVariablesOnPage();
+			void setVariablesAt( long long nItems, long long nCopies, long long nPages );
 
 
 			/////////////////////////////////
@@ -83,6 +86,7 @@ namespace glabels
 			// Private data
 			/////////////////////////////////
 		private:
+			int  mVersion;     // See version()
 
 		};
 
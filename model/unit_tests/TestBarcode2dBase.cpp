@@ -0,0 +1,256 @@
+/*  TestBarcode2dBase.cpp
+ *
+ *  Copyright (C) 2017  Jim Evins <evins@snaught.com>
+ *
+ *  This file is part of gLabels-qt.
+ *
+ *  gLabels-qt is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  gLabels-qt is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with gLabels-qt.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "TestBarcode2dBase.h"
+
+#include "glbarcode/Barcode2dBase.h"
+#include "glbarcode/QtRenderer.h"
+
+#include <QBuffer>
+#include <QPdfWriter>
+
+
+QTEST_MAIN(TestBarcode2dBase)
+
+
+namespace
+{
+
+	///
+	/// 2D barcode of a given pattern of cells
+	///
+	/// Data is the pattern, one row per line, with 'X' for dark cells.
+	///
+	class PatternBarcode : public glbarcode::Barcode2dBase
+	{
+	protected:
+		bool validate( const std::string& rawData ) override
+		{
+			return !rawData.empty();
+		}
+
+		bool encode( const std::string& cookedData, glbarcode::Matrix<bool>& encodedData ) override
+		{
+			QStringList rows = QString::fromStdString( cookedData ).split( '\n' );
+			encodedData.resize( rows[0].size(), rows.size() );
+			for ( int iy = 0; iy < rows.size(); iy++ )
+			{
+				for ( int ix = 0; ix < rows[0].size(); ix++ )
+				{
+					encodedData[iy][ix] = (ix < rows[iy].size()) && (rows[iy][ix] == 'X');
+				}
+			}
+			return true;
+		}
+	};
+
+
+	///
+	/// Pattern barcode vectorized one box per dark cell, as before cells were merged
+	///
+	class CellBarcode : public PatternBarcode
+	{
+	protected:
+		void vectorize( const glbarcode::Matrix<bool>& encodedData, double& w, double& h ) override
+		{
+			const double cellSize = 1.125;  // Unscaled
+			w = cellSize*(encodedData.nx() + 2);
+			h = cellSize*(encodedData.ny() + 2);
+
+			for ( int iy = 0; iy < encodedData.ny(); iy++ )
+			{
+				for ( int ix = 0; ix < encodedData.nx(); ix++ )
+				{
+					if ( encodedData[iy][ix] )
+					{
+						addBox( cellSize*(ix + 1), cellSize*(iy + 1), cellSize, cellSize );
+					}
+				}
+			}
+		}
+	};
+
+
+	///
+	/// Renderer collecting boxes
+	///
+	class BoxRenderer : public glbarcode::Renderer
+	{
+	public:
+		QList<QRectF> boxes;
+
+	protected:
+		void drawBegin( double, double ) override {}
+		void drawEnd() override {}
+		void drawLine( double, double, double, double ) override {}
+		void drawBox( double x, double y, double w, double h ) override { boxes << QRectF( x, y, w, h ); }
+		void drawText( double, double, double, const std::string& ) override {}
+		void drawRing( double, double, double, double ) override {}
+		void drawHexagon( double, double, double ) override {}
+	};
+
+
+	///
+	/// Pseudo-random pattern of n x n cells, about two thirds dark
+	///
+	QString randomPattern( int n )
+	{
+		QString pattern;
+		quint32 state = 12345;
+		for ( int iy = 0; iy < n; iy++ )
+		{
+			if ( iy )
+			{
+				pattern += '\n';
+			}
+			for ( int ix = 0; ix < n; ix++ )
+			{
+				state = state*1103515245 + 12345;
+				pattern += ((state >> 16) % 3) ? 'X' : '.';
+			}
+		}
+		return pattern;
+	}
+
+
+	///
+	/// Size of barcode rendered into a PDF document
+	///
+	int pdfSize( glbarcode::Barcode& bc, bool batched = false )
+	{
+		QBuffer buffer;
+		buffer.open( QIODevice::WriteOnly );
+		{
+			QPdfWriter writer( &buffer );
+			QPainter painter( &writer );
+			glbarcode::QtRenderer renderer( &painter );
+			renderer.setBatched( batched );
+			bc.render( renderer );
+		}
+		return buffer.size();
+	}
+
+}
+
+
+void TestBarcode2dBase::vectorize_data()
+{
+	QTest::addColumn<QString>( "pattern" );
+	QTest::addColumn<int>( "nBoxes" );
+
+	QTest::newRow( "single cell" ) << "X" << 1;
+	QTest::newRow( "empty" ) << "...\n...\n..." << 0;
+	QTest::newRow( "full" ) << "XXX\nXXX\nXXX" << 1;
+	QTest::newRow( "rows" ) << "XXX\n...\nXXX" << 2;
+	QTest::newRow( "columns" ) << "X.X\nX.X\nX.X" << 2;
+	QTest::newRow( "checker" ) << "X.X\n.X.\nX.X" << 5;
+	QTest::newRow( "steps" ) << "XX.\nXXX\nXXX" << 2;
+	QTest::newRow( "finder" ) << "XXXXX\nX...X\nX.X.X\nX...X\nXXXXX" << 5;
+	QTest::newRow( "random" ) << randomPattern( 32 ) << -1;
+}
+
+
+void TestBarcode2dBase::vectorize()
+{
+	QFETCH( QString, pattern );
+	QFETCH( int, nBoxes );
+
+	PatternBarcode bc;
+	bc.build( pattern.toStdString() );
+	BoxRenderer renderer;
+	bc.render( renderer );
+
+	CellBarcode cellBc;
+	cellBc.build( pattern.toStdString() );
+	BoxRenderer cellRenderer;
+	cellBc.render( cellRenderer );
+
+	QCOMPARE( bc.width(), cellBc.width() );
+	QCOMPARE( bc.height(), cellBc.height() );
+	if ( nBoxes >= 0 )
+	{
+		QCOMPARE( renderer.boxes.size(), nBoxes );
+	}
+	QVERIFY( renderer.boxes.size() <= cellRenderer.boxes.size() );
+
+	// Merged boxes cover exactly the dark cells, each only once
+	foreach ( const QRectF& cell, cellRenderer.boxes )
+	{
+		QPointF center = cell.center();
+		int nCovering = 0;
+		foreach ( const QRectF& box, renderer.boxes )
+		{
+			if ( box.contains( center ) )
+			{
+				nCovering++;
+			}
+		}
+		QCOMPARE( nCovering, 1 );
+	}
+	double area = 0, cellArea = 0;
+	foreach ( const QRectF& box, renderer.boxes )
+	{
+		area += box.width()*box.height();
+	}
+	foreach ( const QRectF& cell, cellRenderer.boxes )
+	{
+		cellArea += cell.width()*cell.height();
+	}
+	QVERIFY( qAbs( area - cellArea ) < 1e-6*qMax( cellArea, 1.0 ) );
+}
+
+
+void TestBarcode2dBase::vectorizeBenchmark_data()
+{
+	QTest::addColumn<int>( "n" );
+
+	QTest::newRow( "DataMatrix 144x144" ) << 144;
+	QTest::newRow( "QR version 40" ) << 177;
+}
+
+
+void TestBarcode2dBase::vectorizeBenchmark()
+{
+	QFETCH( int, n );
+
+	std::string pattern = randomPattern( n ).toStdString();
+
+	CellBarcode cellBc;
+	cellBc.build( pattern );
+	BoxRenderer cellRenderer;
+	cellBc.render( cellRenderer );
+
+	PatternBarcode bc;
+	bc.build( pattern );
+	BoxRenderer renderer;
+	bc.render( renderer );
+
+	// Fewer boxes, and smaller documents, than drawing each cell
+	QVERIFY( renderer.boxes.size() < cellRenderer.boxes.size() );
+	int cellPdfSize = pdfSize( cellBc );
+	QVERIFY( pdfSize( bc ) < cellPdfSize );
+	QVERIFY( pdfSize( bc, true ) < cellPdfSize );
+
+	QBENCHMARK
+	{
+		bc.build( pattern );
+		pdfSize( bc );
+	}
+}
@@ -32,6 +32,10 @@
 #include "merge/TextSemicolonKeys.h"
 
 #include "merge/Record.h"
+#include "merge/RecordCursor.h"
+#include "merge/Schema.h"
+#include "merge/SourceLoader.h"
+#include "merge/TextCache.h"
 
 #include <QtDebug>
 
@@ -291,7 +295,8 @@ void TestMerge::text()
 	QCOMPARE( cloneMerge->id(), merge->id() );
 	QCOMPARE( cloneMerge->source(), merge->source() );
 	QCOMPARE( cloneMerge->recordList().size(), merge->recordList().size() );
-	QCOMPARE( *(cloneMerge->recordList()[0]), *(merge->recordList()[0]) ); // Pointers different
+	QCOMPARE( cloneMerge->recordList()[0], merge->recordList()[0] ); // Records shared
+	QCOMPARE( *(cloneMerge->recordList()[0]), *(merge->recordList()[0]) );
 	QCOMPARE( *(cloneMerge->recordList()[1]), *(merge->recordList()[1]) );
 	QCOMPARE( *(cloneMerge->recordList()[2]), *(merge->recordList()[2]) );
 	QCOMPARE( *(cloneMerge->recordList()[3]), *(merge->recordList()[3]) );
@@ -307,6 +312,493 @@ void TestMerge::text()
 }
 
 
+void TestMerge::textBuffering()
+{
+	// Enough data to span several read buffers, with long fields
+	const int nRecords = 3000;
+	QByteArray longValue( 997, 'x' );
+
+	QTemporaryFile file;
+	file.open();
+	file.write( "id,long,quoted\r\n" );
+	for ( int i = 0; i < nRecords; i++ )
+	{
+		file.write( QByteArray::number( i ) );
+		file.write( "," );
+		file.write( longValue );
+		file.write( ",\"q \"\"" );
+		file.write( longValue );
+		file.write( "\"\" \\n\u2019\"\r\n" );
+	}
+	file.close();
+
+	Merge* merge = Factory::createMerge( TextCsvKeys::id() );
+	merge->setSource( file.fileName() );
+	QCOMPARE( merge->nRecords(), nRecords );
+
+	QString quoted = QString( "q \"" ) + QString( longValue ) + QString( "\" \n\u2019" );
+
+	merge->load();
+	const QList<Record*>& recordList = merge->recordList();
+	QCOMPARE( recordList.size(), nRecords );
+	for ( int i = 0; i < nRecords; i++ )
+	{
+		QCOMPARE( recordList[i]->value( "id" ), QString::number( i ) );
+		QCOMPARE( recordList[i]->value( "long" ), QString( longValue ) );
+		QCOMPARE( recordList[i]->value( "quoted" ), quoted );
+	}
+
+	delete merge;
+}
+
+
+void TestMerge::textChunked()
+{
+	// Large enough to be parsed in chunks, with quoted newlines everywhere
+	const int nRecords = 60000;
+
+	QTemporaryFile file;
+	file.open();
+	file.write( "id,\"multi\nline\",short\n" );
+	for ( int i = 0; i < nRecords; i++ )
+	{
+		file.write( QByteArray::number( i ) );
+		file.write( ",\"line 1\nline 2\r\n\"\"line\" 3\n" );
+		file.write( QByteArray( i % 97, 'x' ) );
+		file.write( "\n\"," );
+		if ( i % 3 )
+		{
+			file.write( "\\\n\n" ); // Escaped newline
+		}
+		else
+		{
+			file.write( "\n" );
+		}
+	}
+	file.close();
+
+	Merge* merge = Factory::createMerge( TextCsvKeys::id() );
+	merge->setSource( file.fileName() );
+	QCOMPARE( merge->nRecords(), nRecords );
+	QCOMPARE( merge->keys(), QStringList() << "id" << "multi\nline" << "short" );
+
+	// Records read in chunks match those read one at a time
+	merge->load();
+	const QList<Record*>& recordList = merge->recordList();
+	QCOMPARE( recordList.size(), nRecords );
+
+	Merge* streamMerge = Factory::createMerge( TextCsvKeys::id() );
+	streamMerge->setSource( file.fileName() );
+	RecordCursor cursor( streamMerge );
+	for ( int i = 0; i < nRecords; i++ )
+	{
+		QCOMPARE( recordList[i]->value( "id" ), QString::number( i ) );
+		QCOMPARE( *recordList[i], *cursor.at( i ) );
+	}
+
+	delete streamMerge;
+	delete merge;
+}
+
+
+void TestMerge::textBenchmark_data()
+{
+	QTest::addColumn<int>( "nColumns" );
+
+	QTest::newRow( "10 columns" ) << 10;
+	QTest::newRow( "60 columns" ) << 60;
+}
+
+
+void TestMerge::textBenchmark()
+{
+	QFETCH( int, nColumns );
+
+	// About 32 MB of generated records
+	QTemporaryFile file;
+	file.open();
+	QByteArray line;
+	for ( int iColumn = 0; iColumn < nColumns; iColumn++ )
+	{
+		line += (iColumn ? ",key" : "key") + QByteArray::number( iColumn );
+	}
+	file.write( line + "\n" );
+	qint64 nBytes = 0;
+	for ( int i = 0; nBytes < 32*1024*1024; i++ )
+	{
+		line.clear();
+		for ( int iColumn = 0; iColumn < nColumns; iColumn++ )
+		{
+			line += (iColumn ? "," : "");
+			line += (iColumn % 4) ? QByteArray::number( i * iColumn ) : "\"Quoted, value\"";
+		}
+		line += "\n";
+		nBytes += file.write( line );
+	}
+	file.close();
+
+	Merge* merge = Factory::createMerge( TextCsvKeys::id() );
+	QBENCHMARK
+	{
+		merge->setSource( file.fileName() );
+		merge->load();
+		QVERIFY( merge->recordList().size() > 0 );
+	}
+	delete merge;
+}
+
+
+void TestMerge::fieldFilter()
+{
+	QTemporaryFile file;
+	file.open();
+	file.write( "name,address,city\n" );
+	file.write( "Alice,\"1 Main St, Apt 2\",Springfield,extra1\n" );
+	file.write( "Bob,2 Oak Ave,Shelbyville\n" );
+	file.close();
+
+	Merge* merge = Factory::createMerge( TextCsvKeys::id() );
+	merge->setSource( file.fileName() );
+	merge->load();
+	QCOMPARE( merge->recordList()[0]->value( "address" ), QString( "1 Main St, Apt 2" ) );
+
+	// Only stores filtered fields, reloading any records already loaded
+	merge->setSelected( 0, false );
+	merge->setFieldFilter( QStringList() << "name" << "city" << "4" );
+	QVERIFY( merge->isLoaded() );
+	QCOMPARE( merge->nRecords(), 2 );
+
+	// Selection is kept
+	QCOMPARE( merge->nSelectedRecords(), 1 );
+	QVERIFY( !merge->isSelected( 0 ) );
+	QVERIFY( merge->isSelected( 1 ) );
+	QCOMPARE( merge->selectedIndices(), QVector<int>() << 1 );
+	QCOMPARE( merge->selectedRecords().first(), merge->recordList()[1] );
+	QCOMPARE( merge->keys(), QStringList() << "name" << "address" << "city" << "4" );
+
+	const QList<Record*>& records = merge->recordList();
+	QCOMPARE( records.size(), 2 );
+	QCOMPARE( records[0]->value( "name" ), QString( "Alice" ) );
+	QCOMPARE( records[0]->value( "address" ), QString() );
+	QCOMPARE( records[0]->value( "city" ), QString( "Springfield" ) );
+	QCOMPARE( records[0]->value( "4" ), QString( "extra1" ) );
+	QCOMPARE( records[1]->value( "name" ), QString( "Bob" ) );
+	QCOMPARE( records[1]->value( "address" ), QString() );
+	QCOMPARE( records[1]->value( "city" ), QString( "Shelbyville" ) );
+
+	// Streamed records are filtered too
+	merge->setFieldFilter( QStringList() << "address" );
+	QCOMPARE( merge->selectedRecords().first()->value( "name" ), QString() );
+	Merge* streamMerge = Factory::createMerge( TextCsvKeys::id() );
+	streamMerge->setFieldFilter( QStringList() << "address" );
+	streamMerge->setSource( file.fileName() );
+	{
+		RecordCursor cursor( streamMerge );
+		QCOMPARE( cursor.at( 1 )->value( "name" ), QString() );
+		QCOMPARE( cursor.at( 1 )->value( "address" ), QString( "2 Oak Ave" ) );
+	}
+	delete streamMerge;
+
+	merge->clearFieldFilter();
+	QCOMPARE( merge->nSelectedRecords(), 1 );
+	QCOMPARE( merge->recordList()[1]->value( "name" ), QString( "Bob" ) );
+	QCOMPARE( merge->recordList()[1]->value( "address" ), QString( "2 Oak Ave" ) );
+
+	delete merge;
+
+	// Numbered keys without a header
+	merge = Factory::createMerge( TextCsv::id() );
+	merge->setFieldFilter( QStringList() << "3" );
+	merge->setSource( file.fileName() );
+	merge->load();
+	QCOMPARE( merge->recordList()[1]->value( "1" ), QString() );
+	QCOMPARE( merge->recordList()[1]->value( "3" ), QString( "Springfield" ) );
+	QCOMPARE( merge->recordList()[2]->value( "3" ), QString( "Shelbyville" ) );
+
+	// Numbered keys beyond the columns of the source
+	merge->setFieldFilter( QStringList() << "4" << "900000000" );
+	QCOMPARE( merge->recordList()[1]->value( "3" ), QString() );
+	QCOMPARE( merge->recordList()[1]->value( "4" ), QString( "extra1" ) );
+	QCOMPARE( merge->recordList()[2]->value( "900000000" ), QString() );
+
+	Merge* wideMerge = Factory::createMerge( TextCsv::id() );
+	wideMerge->setFieldFilter( QStringList() << "900000000" );
+	wideMerge->setSource( file.fileName() );
+	QCOMPARE( wideMerge->recordList()[1]->value( "1" ), QString() );
+	QCOMPARE( wideMerge->recordList()[1]->value( "4" ), QString() );
+	delete wideMerge;
+
+	delete merge;
+}
+
+
+void TestMerge::textCache()
+{
+	QTemporaryFile file;
+	file.open();
+	file.write( "name,\"address\"\n" );
+	file.write( "Alice,\"1 Main St,\nSpringfield\"\n" );
+	file.write( "Bob,2 Oak Ave,extra\n" );
+	file.write( "Carol,3 Elm St\n" );
+	file.close();
+	QString cacheFileName = TextCache::fileName( file.fileName() );
+	QFile::remove( cacheFileName );
+
+	Text::setCacheEnabled( true );
+
+	// Parsing source writes cache
+	Merge* merge = Factory::createMerge( TextCsvKeys::id() );
+	merge->setSource( file.fileName() );
+	QVERIFY( QFile::exists( cacheFileName ) );
+	QCOMPARE( merge->nRecords(), 3 );
+
+	TextCache cache;
+	QVERIFY( cache.open( file.fileName(), TextCsvKeys::id() ) );
+	QCOMPARE( cache.keys(), QStringList() << "name" << "address" );
+	QCOMPARE( cache.nRecords(), 3 );
+	QCOMPARE( cache.nFieldsMax(), 3 );
+	QCOMPARE( cache.fields( 0, QVector<bool>() ), QStringList() << "Alice" << "1 Main St,\nSpringfield" );
+	QCOMPARE( cache.fields( 1, QVector<bool>() << false << true ), QStringList() << "" << "2 Oak Ave" << "" );
+	QVERIFY( cache.fields( 3, QVector<bool>() ).isEmpty() );
+	cache.close();
+	QVERIFY( !cache.open( file.fileName(), TextCsv::id() ) ); // Parsed differently
+
+	// Reading from cache gives the same records, also out of order
+	merge->load();
+	Merge* cachedMerge = Factory::createMerge( TextCsvKeys::id() );
+	cachedMerge->setSource( file.fileName() );
+	QCOMPARE( cachedMerge->nRecords(), 3 );
+	QCOMPARE( cachedMerge->keys(), merge->keys() );
+	{
+		RecordCursor cursor( cachedMerge );
+		QCOMPARE( cursor.at( 2 )->value( "name" ), QString( "Carol" ) );
+		QCOMPARE( *cursor.at( 1 ), *merge->recordList()[1] );
+		QCOMPARE( *cursor.at( 0 ), *merge->recordList()[0] );
+		QCOMPARE( cursor.at( 1 )->value( "3" ), QString( "extra" ) );
+	}
+	cachedMerge->load();
+	for ( int i = 0; i < 3; i++ )
+	{
+		QCOMPARE( *cachedMerge->recordList()[i], *merge->recordList()[i] );
+	}
+
+	// Changing source invalidates cache
+	file.open();
+	file.seek( file.size() );
+	file.write( "Dave,4 Pine Rd\n" );
+	file.close();
+	QVERIFY( !cache.open( file.fileName(), TextCsvKeys::id() ) );
+
+	cachedMerge->setSource( file.fileName() );
+	QCOMPARE( cachedMerge->nRecords(), 4 );
+	cachedMerge->load();
+	QCOMPARE( cachedMerge->recordList()[3]->value( "name" ), QString( "Dave" ) );
+	QVERIFY( cache.open( file.fileName(), TextCsvKeys::id() ) );
+	QCOMPARE( cache.nRecords(), 4 );
+	cache.close();
+
+	// Damaged cache is ignored
+	QFile cacheFile( cacheFileName );
+	QVERIFY( cacheFile.resize( cacheFile.size() - 1 ) );
+	QVERIFY( !cache.open( file.fileName(), TextCsvKeys::id() ) );
+	cachedMerge->setSource( file.fileName() );
+	QCOMPARE( cachedMerge->nRecords(), 4 );
+
+	Text::setCacheEnabled( false );
+	delete cachedMerge;
+	delete merge;
+	QFile::remove( cacheFileName );
+}
+
+
+void TestMerge::selection()
+{
+	QTemporaryFile file;
+	file.open();
+	for ( int i = 0; i < 100; i++ )
+	{
+		file.write( QByteArray::number( i ) + "\n" );
+	}
+	file.close();
+
+	Merge* merge = Factory::createMerge( TextCsv::id() );
+	merge->setSource( file.fileName() );
+	QSignalSpy spy( merge, SIGNAL(selectionChanged()) );
+
+	// All selected until loaded, and once loaded
+	QCOMPARE( merge->nSelectedRecords(), 100 );
+	QVERIFY( merge->isSelected( 0 ) );
+	QVERIFY( merge->isSelected( 99 ) );
+	QVERIFY( !merge->isSelected( 100 ) );
+	QVERIFY( !merge->isLoaded() );
+
+	QCOMPARE( merge->selectedRecords().size(), 100 ); // Loads records
+	QVERIFY( merge->isLoaded() );
+	QCOMPARE( merge->nSelectedRecords(), 100 );
+	QVERIFY( merge->isSelected( 99 ) );
+	QCOMPARE( merge->selectedIndices().size(), 100 );
+	QCOMPARE( merge->selectedRecords()[42], merge->recordList()[42] );
+
+	// Unchanged selection is not signalled
+	merge->selectAll();
+	merge->setSelected( 5, true );
+	QCOMPARE( spy.count(), 0 );
+
+	merge->unselectAll();
+	QCOMPARE( spy.count(), 1 );
+	QCOMPARE( merge->nSelectedRecords(), 0 );
+	QVERIFY( merge->selectedIndices().isEmpty() );
+
+	for ( int i = 0; i < 100; i += 7 )
+	{
+		merge->setSelected( i );
+	}
+	merge->setSelected( 14, false );
+	merge->setSelected( 14, false );
+	merge->setSelected( -1 );
+	merge->setSelected( 100 );
+	QCOMPARE( spy.count(), 1 + 15 + 1 );
+	QCOMPARE( merge->nSelectedRecords(), 14 );
+	QVERIFY( merge->isSelected( 7 ) );
+	QVERIFY( !merge->isSelected( 14 ) );
+	QVERIFY( !merge->isSelected( 15 ) );
+
+	const QVector<int>& indices = merge->selectedIndices();
+	QCOMPARE( indices.size(), 14 );
+	QCOMPARE( indices[0], 0 );
+	QCOMPARE( indices[1], 7 );
+	QCOMPARE( indices[2], 21 );
+	QCOMPARE( indices.last(), 98 );
+	QCOMPARE( merge->selectedRecords()[2]->value( "1" ), QString( "21" ) );
+
+	// Selection is copied with merge, records are shared
+	Merge* cloneMerge = merge->clone();
+	QCOMPARE( cloneMerge->nSelectedRecords(), 14 );
+	QCOMPARE( cloneMerge->selectedIndices(), merge->selectedIndices() );
+	QCOMPARE( cloneMerge->recordList()[21], merge->recordList()[21] );
+
+	cloneMerge->unselectAll();
+	QCOMPARE( cloneMerge->nSelectedRecords(), 0 );
+	QCOMPARE( merge->nSelectedRecords(), 14 );
+
+	// Records outlive merge objects that share them
+	RecordCursor cursor( merge );
+	delete cloneMerge;
+	delete merge;
+	QCOMPARE( cursor.size(), 14 );
+	QCOMPARE( cursor.at( 13 )->value( "1" ), QString( "98" ) );
+}
+
+
+void TestMerge::loadSource()
+{
+	QTemporaryFile file1;
+	file1.open();
+	file1.write( "n\n0\n1\n2\n" );
+	file1.close();
+
+	QTemporaryFile file2;
+	file2.open();
+	file2.write( "n,square\n" );
+	for ( int i = 0; i < 5000; i++ )
+	{
+		file2.write( QByteArray::number( i ) + "," + QByteArray::number( i*i ) + "\n" );
+	}
+	file2.close();
+
+	Merge* merge = Factory::createMerge( TextCsvKeys::id() );
+	merge->setSource( file1.fileName() );
+	QCOMPARE( merge->nRecords(), 3 );
+
+	QSignalSpy sourceSpy( merge, SIGNAL(sourceChanged()) );
+	QSignalSpy progressSpy( merge, SIGNAL(loadProgress(int,int)) );
+	QSignalSpy finishedSpy( merge, SIGNAL(loadFinished()) );
+
+	// Current source kept until loaded
+	merge->loadSource( file2.fileName() );
+	QVERIFY( merge->isLoading() );
+	QCOMPARE( merge->source(), file1.fileName() );
+	QCOMPARE( merge->nRecords(), 3 );
+	QCOMPARE( sourceSpy.count(), 0 );
+
+	QVERIFY( finishedSpy.wait() );
+	QVERIFY( !merge->isLoading() );
+	QCOMPARE( sourceSpy.count(), 1 );
+	QVERIFY( progressSpy.count() > 0 );
+	QCOMPARE( merge->source(), file2.fileName() );
+	QCOMPARE( merge->keys(), QStringList() << "n" << "square" );
+	QCOMPARE( merge->nRecords(), 5000 );
+	QCOMPARE( merge->nSelectedRecords(), 5000 );
+	QCOMPARE( merge->recordList()[4999]->value( "square" ), QString( "24990001" ) );
+
+	// Cancelled load keeps current source
+	merge->loadSource( file1.fileName() );
+	merge->cancelLoad();
+	QVERIFY( !merge->isLoading() );
+	QCOMPARE( finishedSpy.count(), 2 );
+	QTest::qWait( 100 );
+	QCOMPARE( sourceSpy.count(), 1 );
+	QCOMPARE( merge->source(), file2.fileName() );
+	QCOMPARE( merge->nRecords(), 5000 );
+
+	// Loading is cancelled along with merge
+	merge->loadSource( file1.fileName() );
+	delete merge;
+}
+
+
+void TestMerge::sourceLoader()
+{
+	const int nRecords = 20000;
+
+	QTemporaryFile file;
+	file.open();
+	file.write( "n,square\n" );
+	for ( int i = 0; i < nRecords; i++ )
+	{
+		file.write( QByteArray::number( i ) + "," + QByteArray::number( i*i ) + "\n" );
+	}
+	file.close();
+
+	Merge* merge = Factory::createMerge( TextCsvKeys::id() );
+
+	// Progress reported while loading
+	{
+		SourceLoader loader( merge, file.fileName() );
+		QSignalSpy progressSpy( &loader, SIGNAL(progress(int,int)) );
+		loader.start();
+		QVERIFY( loader.wait( 60000 ) );
+		QVERIFY( !loader.isCancelled() );
+		QVERIFY( progressSpy.count() > 0 );
+		QCOMPARE( loader.result()->nRecords(), nRecords );
+		QCOMPARE( loader.result()->source(), file.fileName() );
+	}
+
+	// Cancelled loading stops at next progress update
+	{
+		SourceLoader loader( merge, file.fileName() );
+		loader.cancel();
+		loader.start();
+		QVERIFY( loader.wait( 60000 ) );
+		QVERIFY( loader.isCancelled() );
+		QVERIFY( loader.result()->nRecords() < nRecords );
+	}
+
+	// Destroying loader cancels loading, and waits for it to stop
+	{
+		auto* loader = new SourceLoader( merge, file.fileName() );
+		loader->start();
+		delete loader;
+	}
+
+	// Loaders leave merge object alone
+	QVERIFY( !merge->isLoading() );
+	QVERIFY( merge->source().isEmpty() );
+
+	delete merge;
+}
+
+
 void TestMerge::none()
 {
 	None none;
@@ -323,25 +815,138 @@ void TestMerge::none()
 void TestMerge::record()
 {
 	Record record;
-	QCOMPARE( record.isSelected(), true );
-	record.setSelected( false );
-	QCOMPARE( record.isSelected(), false );
-	record.setSelected( true );
-	QCOMPARE( record.isSelected(), true );
-
 	record["key"] = "val";
 	QVERIFY( record.contains( "key" ) );
 	QCOMPARE( record["key"], QString( "val" ) );
 
 	Record* cloneRecord = record.clone();
-	QCOMPARE( cloneRecord->isSelected(), true );
 	QVERIFY( cloneRecord->contains( "key" ) );
 	QCOMPARE( cloneRecord->value( "key" ), QString( "val" ) );
 	delete cloneRecord;
 
-	record.setSelected( false );
 	Record record2( &record );
-	QCOMPARE( record2.isSelected(), false );
 	QVERIFY( record2.contains( "key" ) );
 	QCOMPARE( record2["key"], QString( "val" ) );
 }
+
+
+void TestMerge::recordSchema()
+{
+	QSharedPointer<Schema> schema( new Schema );
+	QCOMPARE( schema->size(), 0 );
+	QCOMPARE( schema->indexOf( "a" ), -1 );
+	QCOMPARE( schema->addKey( "a" ), 0 );
+	QCOMPARE( schema->addKey( "b" ), 1 );
+	QCOMPARE( schema->addKey( "a" ), 0 ); // Already there
+	QCOMPARE( schema->size(), 2 );
+	QCOMPARE( schema->indexOf( "b" ), 1 );
+	QCOMPARE( schema->key( 1 ), QString( "b" ) );
+	QCOMPARE( schema->keys(), QStringList() << "a" << "b" );
+
+	Record record1( schema );
+	record1.setField( 0, "val1a" );
+	QCOMPARE( record1.nFields(), 1 );
+	QVERIFY( record1.contains( "a" ) );
+	QVERIFY( !record1.contains( "b" ) );
+	QCOMPARE( record1.value( "b" ), QString() );
+	QCOMPARE( record1.field( 0 ), QString( "val1a" ) );
+
+	Record record2( schema );
+	record2["c"] = "val2c"; // New key added to shared schema
+	QCOMPARE( schema->size(), 3 );
+	QCOMPARE( record2.nFields(), 3 );
+	QVERIFY( record2.contains( "a" ) );
+	QCOMPARE( record2.value( "a" ), QString( "" ) );
+	QCOMPARE( record2.field( 2 ), QString( "val2c" ) );
+	QVERIFY( !record1.contains( "c" ) );
+
+	// Keys and values in sorted key order, whatever the field order
+	Record record3;
+	record3["z"] = "val3z";
+	record3["c"] = "val3c";
+	record3["a"] = "";
+	QCOMPARE( record3.keys(), QList<QString>() << "a" << "c" << "z" );
+	QCOMPARE( record3.values(), QList<QString>() << "" << "val3c" << "val3z" );
+
+	// Equality does not depend on schema
+	Record record4;
+	record4["c"] = "val2c";
+	record4["a"] = "";
+	QVERIFY( record4 != record2 ); // record2 also contains "b"
+	record4["b"] = "";
+	QVERIFY( record4 == record2 );
+	record4["b"] = "x";
+	QVERIFY( record4 != record2 );
+}
+
+
+void TestMerge::recordCursor()
+{
+	QTemporaryFile file;
+	file.open();
+	file.write( "key,n\n" );
+	for ( int i = 0; i < 5; i++ )
+	{
+		file.write( QString( "val%1,%1\n" ).arg( i ).toLatin1() );
+	}
+	file.close();
+
+	Merge* merge = Factory::createMerge( TextCsvKeys::id() );
+	merge->setSource( file.fileName() );
+	QCOMPARE( merge->nRecords(), 5 );
+	QCOMPARE( merge->nSelectedRecords(), 5 ); // Initially all selected
+	QCOMPARE( merge->keys(), QStringList() << "key" << "n" );
+
+	//
+	// Records read directly from source
+	//
+	{
+		RecordCursor cursor( merge );
+		QCOMPARE( cursor.size(), 5 );
+		QCOMPARE( cursor.at( 0 )->value( "key" ), QString( "val0" ) );
+		QCOMPARE( cursor.at( 0 )->value( "key" ), QString( "val0" ) ); // Same again
+		QCOMPARE( cursor.at( 3 )->value( "key" ), QString( "val3" ) ); // Skip forward
+		QCOMPARE( cursor.at( 4 )->value( "n" ), QString( "4" ) );
+		QCOMPARE( cursor.at( 1 )->value( "key" ), QString( "val1" ) ); // Start over
+		QVERIFY( cursor.at( 5 ) == nullptr );
+		QVERIFY( cursor.at( -1 ) == nullptr );
+
+		// Copies read from source too
+		Merge* cloneMerge = merge->clone();
+		QCOMPARE( cloneMerge->nRecords(), 5 );
+		RecordCursor cloneCursor( cloneMerge );
+		QCOMPARE( cloneCursor.at( 2 )->value( "key" ), QString( "val2" ) );
+		delete cloneMerge;
+	}
+
+	//
+	// Loaded records
+	//
+	merge->load();
+	QCOMPARE( merge->recordList().size(), 5 );
+	merge->unselectAll();
+	merge->setSelected( 1 );
+	merge->setSelected( 4 );
+	{
+		RecordCursor cursor( merge );
+		QCOMPARE( cursor.size(), 2 );
+		QCOMPARE( cursor.at( 0 ), merge->recordList()[1] ); // Pointers same
+		QCOMPARE( cursor.at( 1 ), merge->recordList()[4] );
+		QVERIFY( cursor.at( 2 ) == nullptr );
+	}
+
+	//
+	// Changing source drops loaded records
+	//
+	merge->setSource( file.fileName() );
+	QCOMPARE( merge->nSelectedRecords(), 5 );
+	{
+		RecordCursor cursor;
+		QCOMPARE( cursor.size(), 0 );
+		cursor.setMerge( merge );
+		QCOMPARE( cursor.size(), 5 );
+		QCOMPARE( cursor.at( 4 )->value( "key" ), QString( "val4" ) );
+	}
+
+	delete merge;
+}
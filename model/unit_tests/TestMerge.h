@@ -32,6 +32,17 @@ private slots:
 	void factoryNotRegistered();
 	void text_data();
 	void text();
+	void textBuffering();
+	void textChunked();
+	void textBenchmark_data();
+	void textBenchmark();
+	void fieldFilter();
+	void textCache();
+	void selection();
+	void loadSource();
+	void sourceLoader();
 	void none();
 	void record();
+	void recordSchema();
+	void recordCursor();
 };
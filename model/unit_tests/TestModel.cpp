@@ -20,9 +20,12 @@
 
 #include "TestModel.h"
 
+#include "model/BarcodeCache.h"
+#include "model/EvaluationCache.h"
 #include "model/Model.h"
 #include "model/ModelBoxObject.h"
 #include "model/ModelEllipseObject.h"
+#include "model/ModelImageObject.h"
 #include "model/ModelLineObject.h"
 #include "model/ModelTextObject.h"
 #include "model/FrameRect.h"
@@ -36,6 +39,7 @@
 #include "merge/TextCsv.h"
 #include "merge/TextCsvKeys.h"
 
+#include <QImage>
 #include <QtDebug>
 
 
@@ -494,3 +498,204 @@ void TestModel::saveRestore()
 	delete saved;
 	delete modified;
 }
+
+
+void TestModel::fieldNames()
+{
+	Model model;
+	QCOMPARE( model.fieldNames(), QStringList() );
+
+	auto* box = new ModelBoxObject();
+	box->setFillColorNode( ColorNode( "fill" ) );
+	box->setLineColorNode( ColorNode( Qt::red ) );
+	model.addObject( box );
+	QCOMPARE( box->fieldNames(), QStringList() << "fill" );
+
+	auto* text = new ModelTextObject();
+	text->setText( "${name} lives at ${address:%-10s}, ${name}" );
+	text->setTextColorNode( ColorNode( "fill" ) );
+	model.addObject( text );
+	QCOMPARE( text->fieldNames(), QStringList() << "fill" << "name" << "address" );
+
+	auto* image = new ModelImageObject();
+	image->setFilenameNode( TextNode( true, "photo" ) );
+	model.addObject( image );
+	QCOMPARE( image->fieldNames(), QStringList() << "photo" );
+
+	auto* image2 = new ModelImageObject();
+	image2->setFilenameNode( TextNode( false, "logo.png" ) );
+	model.addObject( image2 );
+	QCOMPARE( image2->fieldNames(), QStringList() );
+
+	QCOMPARE( model.fieldNames(), QStringList() << "fill" << "name" << "address" << "photo" );
+}
+
+
+void TestModel::evaluationCache()
+{
+	Record record;
+	record["name"] = "Alice";
+	record["color"] = "#ff0000";
+	record["file"] = "a.png";
+
+	Variables variables;
+	variables.addVariable( Variable( Variable::Type::STRING, "greeting", "Hello" ) );
+
+	RawText rawText( "${greeting} ${name}" );
+	ColorNode colorNode( true, QColor(), "color" );
+	TextNode textNode( true, "file" );
+
+	EvaluationCache cache;
+	QVERIFY( !cache.isActive( &record, &variables ) );
+
+	cache.begin( &record, &variables );
+	QVERIFY( cache.isActive( &record, &variables ) );
+	QVERIFY( !cache.isActive( nullptr, &variables ) );
+
+	QCOMPARE( cache.expand( rawText ), QString( "Hello Alice" ) );
+	QCOMPARE( cache.color( colorNode ), QColor( 255, 0, 0 ) );
+	QCOMPARE( cache.text( textNode ), QString( "a.png" ) );
+
+	// Results are kept until end of label, so evaluated once per label
+	record["name"] = "Bob";
+	record["color"] = "#00ff00";
+	record["file"] = "b.png";
+	QCOMPARE( cache.expand( rawText ), QString( "Hello Alice" ) );
+	QCOMPARE( cache.expand( RawText( "${greeting} ${name}" ) ), QString( "Hello Alice" ) );
+	QCOMPARE( cache.color( ColorNode( true, QColor(), "color" ) ), QColor( 255, 0, 0 ) );
+	QCOMPARE( cache.text( textNode ), QString( "a.png" ) );
+
+	// Constant nodes are not looked up
+	QCOMPARE( cache.expand( RawText( "text" ) ), QString( "text" ) );
+	QCOMPARE( cache.color( ColorNode( QColor( 0, 0, 255 ) ) ), QColor( 0, 0, 255 ) );
+	QCOMPARE( cache.text( TextNode( false, "c.png" ) ), QString( "c.png" ) );
+
+	cache.end();
+	QVERIFY( !cache.isActive( &record, &variables ) );
+
+	cache.begin( &record, &variables );
+	QCOMPARE( cache.expand( rawText ), QString( "Hello Bob" ) );
+	QCOMPARE( cache.color( colorNode ), QColor( 0, 255, 0 ) );
+	QCOMPARE( cache.text( textNode ), QString( "b.png" ) );
+	cache.end();
+
+	// Model only has a cache while drawing
+	Model model;
+	QVERIFY( model.evaluationCache( &record, &variables ) == nullptr );
+}
+
+
+void TestModel::staticLayers()
+{
+	Record record;
+	record["fill"] = "#00ff00";
+
+	Variables variables;
+
+	ColorNode black( Qt::black );
+	auto* bottom = new ModelBoxObject( 10, 10, 60, 60, false, 1, black, ColorNode( Qt::red ) );
+	auto* field  = new ModelBoxObject( 20, 20, 60, 60, false, 1, black, ColorNode( true, QColor(), "fill" ) );
+	auto* middle = new ModelBoxObject( 30, 30, 60, 60, false, 1, black, ColorNode( Qt::blue ) );
+	auto* top    = new ModelBoxObject( 40, 40, 60, 60, false, 2, black, ColorNode( Qt::yellow ) );
+
+	Model model;
+	model.addObject( bottom );
+	model.addObject( field );
+	model.addObject( middle );
+	model.addObject( top );
+
+	// Runs of objects without fields are recorded together
+	QCOMPARE( model.nStaticLayers(), 2 );
+
+	auto drawModel = [&]() -> QImage
+	{
+		QImage image( 120, 120, QImage::Format_ARGB32 );
+		image.fill( Qt::white );
+		QPainter painter( &image );
+		model.draw( &painter, false, &record, &variables );
+		return image;
+	};
+	auto drawObjects = [&]() -> QImage
+	{
+		QImage image( 120, 120, QImage::Format_ARGB32 );
+		image.fill( Qt::white );
+		QPainter painter( &image );
+		foreach ( ModelObject* object, model.objectList() )
+		{
+			object->draw( &painter, false, &record, &variables );
+		}
+		return image;
+	};
+
+	// Replayed layers are drawn in order, as the objects themselves
+	QImage image = drawModel();
+	QCOMPARE( image, drawObjects() );
+	QCOMPARE( image.pixel( 25, 25 ), QColor( Qt::green ).rgb() );
+	QCOMPARE( image.pixel( 85, 85 ), QColor( Qt::yellow ).rgb() );
+
+	record["fill"] = "#ff00ff";
+	image = drawModel();
+	QCOMPARE( image, drawObjects() );
+	QCOMPARE( image.pixel( 25, 25 ), QColor( Qt::magenta ).rgb() );
+
+	// Recorded layers follow changes to the model
+	middle->setFillColorNode( ColorNode( Qt::cyan ) );
+	image = drawModel();
+	QCOMPARE( image, drawObjects() );
+	QCOMPARE( image.pixel( 35, 35 ), QColor( Qt::cyan ).rgb() );
+
+	middle->setFillColorNode( ColorNode( true, QColor(), "fill" ) );
+	QCOMPARE( model.nStaticLayers(), 2 );
+	QCOMPARE( drawModel(), drawObjects() );
+
+	model.deleteObject( field );
+	delete field;
+	QCOMPARE( model.nStaticLayers(), 2 );
+	QCOMPARE( drawModel(), drawObjects() );
+
+	model.selectAll();
+	model.raiseSelectionToTop();
+	QCOMPARE( drawModel(), drawObjects() );
+}
+
+
+void TestModel::barcodeCache()
+{
+	BarcodeCache cache( 2 );
+	QCOMPARE( cache.capacity(), 2 );
+	QCOMPARE( cache.size(), 0 );
+
+	glbarcode::Barcode* bc1 = cache.barcode( "code39", "ABC", 0, 0, true, true );
+	QVERIFY( bc1 != nullptr );
+	QVERIFY( bc1->isDataValid() );
+	QCOMPARE( cache.nMisses(), 1 );
+	QCOMPARE( cache.nHits(), 0 );
+
+	// Same barcode is built once
+	QCOMPARE( cache.barcode( "code39", "ABC", 0, 0, true, true ), bc1 );
+	QCOMPARE( cache.nMisses(), 1 );
+	QCOMPARE( cache.nHits(), 1 );
+
+	// Flags, size and data are all part of the key
+	glbarcode::Barcode* bc2 = cache.barcode( "code39", "ABC", 0, 0, false, true );
+	QVERIFY( bc2 != bc1 );
+	QCOMPARE( cache.nMisses(), 2 );
+	QCOMPARE( cache.size(), 2 );
+
+	// Least recently used is dropped
+	cache.barcode( "code39", "ABC", 0, 0, true, true );
+	cache.barcode( "code39", "XYZ", 0, 0, true, true );
+	QCOMPARE( cache.size(), 2 );
+	QCOMPARE( cache.nMisses(), 3 );
+	QCOMPARE( cache.nHits(), 2 );
+	cache.barcode( "code39", "ABC", 0, 0, true, true );
+	QCOMPARE( cache.nHits(), 3 );
+	cache.barcode( "code39", "ABC", 0, 0, false, true );
+	QCOMPARE( cache.nMisses(), 4 );
+
+	// Unknown style
+	QVERIFY( cache.barcode( "no-such-style", "ABC", 0, 0, true, true ) == nullptr );
+
+	cache.clear();
+	QCOMPARE( cache.size(), 0 );
+}
@@ -29,4 +29,8 @@ private slots:
 	void initTestCase();
 	void model();
 	void saveRestore();
+	void fieldNames();
+	void evaluationCache();
+	void staticLayers();
+	void barcodeCache();
 };
@@ -0,0 +1,355 @@
+/*  TestPageRenderer.cpp
+ *
+ *  Copyright (C) 2019  Jim Evins <evins@snaught.com>
+ *
+ *  This file is part of gLabels-qt.
+ *
+ *  gLabels-qt is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  gLabels-qt is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with gLabels-qt.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "TestPageRenderer.h"
+
+#include "model/FrameRect.h"
+#include "model/Layout.h"
+#include "model/Model.h"
+#include "model/ModelBoxObject.h"
+#include "model/ModelTextObject.h"
+#include "model/PageRenderer.h"
+#include "model/Settings.h"
+#include "model/Template.h"
+#include "model/Variables.h"
+
+#include "merge/Factory.h"
+#include "merge/Merge.h"
+#include "merge/TextCsvKeys.h"
+
+#include <QImage>
+#include <QPicture>
+#include <QPrinter>
+#include <QRegularExpression>
+#include <QTemporaryDir>
+#include <QtDebug>
+
+
+QTEST_MAIN(TestPageRenderer)
+
+using namespace glabels::model;
+using namespace glabels::merge;
+
+
+namespace
+{
+	const int nRecords = 30;
+
+
+	///
+	/// Write merge source, with a name and fill color per record
+	///
+	void writeSource( QTemporaryFile& file )
+	{
+		file.open();
+		file.write( "name,color\n" );
+		for ( int i = 0; i < nRecords; i++ )
+		{
+			file.write( QString( "Name %1,#%2\n" ).arg( i ).arg( (i * 0x2f3b71) & 0xffffff, 6, 16, QChar('0') ).toLatin1() );
+		}
+		file.close();
+	}
+
+
+	///
+	/// Create merge project, 8 labels per page
+	///
+	/// Labels show their record and a variable incremented per item, so that
+	/// every label and page differs.
+	///
+	Model* createModel( const QString& source, bool loaded )
+	{
+		Template tmplate( "Test Brand", "part", "desc", "testPaperId", 200, 200 );
+		auto* frame = new FrameRect( 90, 40, 5, 0, 0, "rect1" );
+		frame->addLayout( Layout( 2, 4, 5, 5, 100, 50 ) );
+		tmplate.addFrame( frame );
+
+		auto* model = new Model();
+		model->setTmplate( &tmplate );
+
+		model->variables()->addVariable( Variable( Variable::Type::INTEGER, "n", "1",
+		                                           Variable::Increment::PER_ITEM, "1" ) );
+
+		ColorNode black( Qt::black );
+		model->addObject( new ModelBoxObject( 2, 2, 86, 36, false, 1, black, ColorNode( true, QColor(), "color" ) ) );
+		model->addObject( new ModelTextObject( 5, 5, 80, 30, false, "${name} #${n}", "Sans", 10,
+		                                       QFont::Normal, false, false, black,
+		                                       Qt::AlignLeft, Qt::AlignTop, QTextOption::WordWrap, 1, false ) );
+
+		Merge* merge = Factory::createMerge( TextCsvKeys::id() );
+		merge->setSource( source );
+		if ( loaded )
+		{
+			merge->load();
+		}
+		model->setMerge( merge );
+
+		return model;
+	}
+
+
+	///
+	/// Delete model, along with its merge object and variables
+	///
+	void deleteModel( Model* model )
+	{
+		Merge*     merge     = model->merge();
+		Variables* variables = model->variables();
+
+		delete model;
+		delete merge;
+		delete variables;
+	}
+
+
+	///
+	/// Configure renderer for merge job
+	///
+	void setJob( PageRenderer& renderer, int nCopies, bool collated )
+	{
+		renderer.setNCopies( nCopies );
+		renderer.setStartItem( 1 );
+		renderer.setIsCollated( collated );
+		renderer.setAreGroupsContiguous( true );
+	}
+
+
+	///
+	/// Render the pages of a picture file written by PageRenderer::printPictures()
+	///
+	QList<QImage> readPictureFile( const QString& fileName )
+	{
+		QList<QImage> pages;
+
+		QFile file( fileName );
+		if ( !file.open( QFile::ReadOnly ) )
+		{
+			return pages;
+		}
+
+		QDataStream stream( &file );
+		stream.setVersion( QDataStream::Qt_5_0 );
+
+		quint32 magic;
+		qint32  version;
+		QSizeF  size;
+		qint32  iFirstPage, nPages;
+		stream >> magic >> version >> size >> iFirstPage >> nPages;
+
+		for ( int i = 0; (i < nPages) && (stream.status() == QDataStream::Ok); i++ )
+		{
+			QPicture picture;
+			stream >> picture;
+
+			QImage image( 2*size.toSize(), QImage::Format_RGB32 );
+			image.fill( Qt::white );
+			QPainter painter( &image );
+			painter.scale( 2, 2 );
+			painter.drawPicture( 0, 0, picture );
+			painter.end();
+
+			pages << image;
+		}
+
+		return pages;
+	}
+
+
+	///
+	/// Read PDF file, blanking out its creation time and document id
+	///
+	/// These differ each time a file is written, so are left out when
+	/// comparing files.
+	///
+	QString readPdfFile( const QString& fileName )
+	{
+		QFile file( fileName );
+		if ( !file.open( QFile::ReadOnly ) )
+		{
+			return QString();
+		}
+
+		QString pdf = QString::fromLatin1( file.readAll() );
+		pdf.replace( QRegularExpression( "\\(D:[^)]*\\)" ), "(D:)" );
+		pdf.replace( QRegularExpression( "\\d{4}-\\d\\d-\\d\\dT[0-9:.+\\-Z]*" ), "" );
+		pdf.replace( QRegularExpression( "uuid:[0-9a-fA-F\\-]*" ), "uuid:" );
+		pdf.replace( QRegularExpression( "/ID \\[[^\\]]*\\]" ), "/ID []" );
+
+		return pdf;
+	}
+}
+
+
+void TestPageRenderer::initTestCase()
+{
+	Factory::init();
+	Settings::init();
+}
+
+
+void TestPageRenderer::printPictures_data()
+{
+	QTest::addColumn<int>( "nJobs" );
+	QTest::addColumn<int>( "nCopies" );
+	QTest::addColumn<bool>( "collated" );
+	QTest::addColumn<bool>( "loaded" );
+
+	QTest::newRow( "2 jobs" ) << 2 << 1 << false << false;
+	QTest::newRow( "3 jobs, loaded records" ) << 3 << 1 << false << true;
+	QTest::newRow( "3 jobs, 2 copies collated" ) << 3 << 2 << true << false;
+	QTest::newRow( "8 jobs, 3 copies" ) << 8 << 3 << false << false;
+}
+
+
+void TestPageRenderer::printPictures()
+{
+	QFETCH( int, nJobs );
+	QFETCH( int, nCopies );
+	QFETCH( bool, collated );
+	QFETCH( bool, loaded );
+
+	QTemporaryFile source;
+	writeSource( source );
+
+	Model* model = createModel( source.fileName(), loaded );
+	PageRenderer renderer( model );
+	setJob( renderer, nCopies, collated );
+	QVERIFY( renderer.nPages() > nJobs );
+
+	QTemporaryDir dir;
+	QString serialFileName   = dir.path() + "/serial.glp";
+	QString parallelFileName = dir.path() + "/parallel.glp";
+	QVERIFY( renderer.printPictures( serialFileName, 1 ) );
+	QVERIFY( renderer.printPictures( parallelFileName, nJobs ) );
+
+	// Pages recorded concurrently draw the same as those recorded in order
+	QList<QImage> serialPages   = readPictureFile( serialFileName );
+	QList<QImage> parallelPages = readPictureFile( parallelFileName );
+	QCOMPARE( serialPages.size(), renderer.nPages() );
+	QCOMPARE( parallelPages.size(), serialPages.size() );
+	for ( int i = 0; i < serialPages.size(); i++ )
+	{
+		QVERIFY2( parallelPages[i] == serialPages[i], qPrintable( QString( "Page %1 differs" ).arg( i + 1 ) ) );
+	}
+
+	// Pages differ from each other, so are in order
+	QVERIFY( serialPages[0] != serialPages[1] );
+
+	// Part of the job
+	renderer.setPrintRange( 1, 2 );
+	QVERIFY( renderer.printPictures( parallelFileName, nJobs ) );
+	parallelPages = readPictureFile( parallelFileName );
+	QCOMPARE( parallelPages.size(), 2 );
+	QVERIFY( parallelPages[0] == serialPages[1] );
+	QVERIFY( parallelPages[1] == serialPages[2] );
+
+	deleteModel( model );
+}
+
+
+void TestPageRenderer::printImages_data()
+{
+	QTest::addColumn<int>( "nJobs" );
+	QTest::addColumn<bool>( "perLabel" );
+
+	QTest::newRow( "3 jobs, pages" ) << 3 << false;
+	QTest::newRow( "4 jobs, labels" ) << 4 << true;
+}
+
+
+void TestPageRenderer::printImages()
+{
+	QFETCH( int, nJobs );
+	QFETCH( bool, perLabel );
+
+	QTemporaryFile source;
+	writeSource( source );
+
+	Model* model = createModel( source.fileName(), false );
+	PageRenderer renderer( model );
+	setJob( renderer, 1, false );
+
+	QTemporaryDir serialDir;
+	QTemporaryDir parallelDir;
+	QVERIFY( renderer.printImages( serialDir.path() + "/%1.png", "png", 72, perLabel, 1 ) );
+	QVERIFY( renderer.printImages( parallelDir.path() + "/%1.png", "png", 72, perLabel, nJobs ) );
+
+	// Images rendered concurrently are the same as those rendered in order
+	int nImages = perLabel ? renderer.nItems() : renderer.nPages();
+	QStringList fileNames = QDir( serialDir.path() ).entryList( QStringList() << "*.png", QDir::Files, QDir::Name );
+	QCOMPARE( fileNames.size(), nImages );
+	QCOMPARE( QDir( parallelDir.path() ).entryList( QStringList() << "*.png", QDir::Files, QDir::Name ), fileNames );
+	foreach ( const QString& fileName, fileNames )
+	{
+		QImage serialImage( serialDir.path() + "/" + fileName );
+		QImage parallelImage( parallelDir.path() + "/" + fileName );
+		QVERIFY( !serialImage.isNull() );
+		QVERIFY2( parallelImage == serialImage, qPrintable( fileName + " differs" ) );
+	}
+
+	deleteModel( model );
+}
+
+
+void TestPageRenderer::printPdf_data()
+{
+	QTest::addColumn<int>( "nCopies" );
+	QTest::addColumn<bool>( "collated" );
+
+	QTest::newRow( "1 copy" ) << 1 << false;
+	QTest::newRow( "2 copies collated" ) << 2 << true;
+}
+
+
+void TestPageRenderer::printPdf()
+{
+	QFETCH( int, nCopies );
+	QFETCH( bool, collated );
+
+	QTemporaryFile source;
+	writeSource( source );
+
+	Model* model = createModel( source.fileName(), false );
+	PageRenderer renderer( model );
+	setJob( renderer, nCopies, collated );
+	QVERIFY( renderer.nPages() > 1 );
+
+	QTemporaryDir dir;
+	QString serialFileName   = dir.path() + "/serial.pdf";
+	QString parallelFileName = dir.path() + "/parallel.pdf";
+
+	QPrinter serialPrinter( QPrinter::HighResolution );
+	serialPrinter.setOutputFormat( QPrinter::PdfFormat );
+	serialPrinter.setOutputFileName( serialFileName );
+	renderer.print( &serialPrinter, 1 );
+
+	QPrinter parallelPrinter( QPrinter::HighResolution );
+	parallelPrinter.setOutputFormat( QPrinter::PdfFormat );
+	parallelPrinter.setOutputFileName( parallelFileName );
+	renderer.print( &parallelPrinter, 4 );
+
+	// Pages printed concurrently are printed exactly as those printed in order
+	QString serialPdf   = readPdfFile( serialFileName );
+	QString parallelPdf = readPdfFile( parallelFileName );
+	QVERIFY( !serialPdf.isEmpty() );
+	QVERIFY( parallelPdf == serialPdf );
+
+	deleteModel( model );
+}
@@ -21,8 +21,10 @@
 #include "TestRawText.h"
 
 #include "model/RawText.h"
+#include "model/Variables.h"
 
 #include "merge/Record.h"
+#include "merge/Schema.h"
 
 #include <QtDebug>
 
@@ -78,6 +80,7 @@ void TestRawText::rawText()
 
 	rawText = "${key1}text${key2}";
 	QVERIFY( rawText.hasPlaceHolders() );
+	QCOMPARE( rawText.fieldNames(), QStringList() << "key1" << "key2" );
 	QCOMPARE( rawText.expand( &record, nullptr ), QString( "val1textval2" ) );
 
 	rawText = "text1${key1}text2${key2}text3";
@@ -91,4 +94,84 @@ void TestRawText::rawText()
 	rawText = "${key2}${key3}${key1}";
 	QVERIFY( rawText.hasPlaceHolders() );
 	QCOMPARE( rawText.expand( &record, nullptr ), QString( "val2val1" ) );
+
+	rawText = "${key3:=default}";
+	QVERIFY( rawText.hasPlaceHolders() );
+	QCOMPARE( rawText.expand( &record, nullptr ), QString( "default" ) );
+
+	rawText = "$ {key1} ${key1";
+	QVERIFY( !rawText.hasPlaceHolders() );
+}
+
+
+void TestRawText::expandBinding()
+{
+	RawText rawText( "${a}-${b}-${v}" );
+
+	QSharedPointer<Schema> schema( new Schema );
+	Record record1( schema );
+	record1["a"] = "1";
+	record1["b"] = "2";
+	Record record2( schema );
+	record2["b"] = "3";
+
+	QCOMPARE( rawText.expand( &record1, nullptr ), QString( "1-2-" ) );
+	QCOMPARE( rawText.expand( &record2, nullptr ), QString( "-3-" ) );
+
+	///
+	/// Variables added after binding
+	///
+	Variables variables;
+	QCOMPARE( rawText.expand( &record1, &variables ), QString( "1-2-" ) );
+
+	variables.addVariable( Variable( Variable::Type::STRING, "v", "x" ) );
+	QCOMPARE( rawText.expand( &record1, &variables ), QString( "1-2-x" ) );
+
+	variables.addVariable( Variable( Variable::Type::STRING, "a", "y" ) );
+	QCOMPARE( rawText.expand( &record2, &variables ), QString( "y-3-x" ) );
+
+	variables.deleteVariable( "a" );
+	QCOMPARE( rawText.expand( &record2, &variables ), QString( "-3-x" ) );
+
+	///
+	/// Variable values change without rebinding
+	///
+	variables.replaceVariable( "v", Variable( Variable::Type::INTEGER, "v", "1",
+	                                          Variable::Increment::PER_ITEM, "1" ) );
+	QCOMPARE( rawText.expand( &record1, &variables ), QString( "1-2-1" ) );
+	variables.incrementVariablesOnItem();
+	QCOMPARE( rawText.expand( &record1, &variables ), QString( "1-2-2" ) );
+
+	///
+	/// Copy of variables
+	///
+	Variables* variables2 = variables.clone();
+	variables2->incrementVariablesOnItem();
+	QCOMPARE( rawText.expand( &record1, variables2 ), QString( "1-2-3" ) );
+	QCOMPARE( rawText.expand( &record1, &variables ), QString( "1-2-2" ) );
+	delete variables2;
+
+	///
+	/// Key added to schema after binding
+	///
+	RawText rawText2( "${c}${a}" );
+	QCOMPARE( rawText2.expand( &record1, nullptr ), QString( "1" ) );
+	Record record3( schema );
+	record3["c"] = "4";
+	QCOMPARE( rawText2.expand( &record3, nullptr ), QString( "4" ) );
+
+	///
+	/// Other schema, with keys in other order
+	///
+	Record record4;
+	record4["b"] = "5";
+	record4["a"] = "6";
+	QCOMPARE( rawText.expand( &record4, &variables ), QString( "6-5-2" ) );
+
+	///
+	/// Expanded text unchanged by later expansions
+	///
+	QString text = rawText.expand( &record1, &variables );
+	rawText.expand( &record4, &variables );
+	QCOMPARE( text, QString( "1-2-2" ) );
 }
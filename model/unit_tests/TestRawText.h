@@ -27,4 +27,5 @@ class TestRawText : public QObject
 
 private slots:
 	void rawText();
+	void expandBinding();
 };
@@ -351,6 +351,49 @@ void TestSubstitutionField::formattedIntEvaluation()
 }
 
 
+void TestSubstitutionField::formatFlags_data()
+{
+	QTest::addColumn<QString>( "field" );
+	QTest::addColumn<QString>( "value" );
+	QTest::addColumn<QString>( "expected" );
+
+	QTest::newRow( "width" )              << "${x:%5d}"    << "42"   << "   42";
+	QTest::newRow( "left align" )         << "${x:%-5d}"   << "42"   << "42   ";
+	QTest::newRow( "left align zero" )    << "${x:%-05d}"  << "-42"  << "-42  ";
+	QTest::newRow( "plus sign" )          << "${x:%+d}"    << "42"   << "+42";
+	QTest::newRow( "space sign" )         << "${x:% d}"    << "42"   << " 42";
+	QTest::newRow( "plus zero pad" )      << "${x:%+06d}"  << "42"   << "+00042";
+	QTest::newRow( "precision" )          << "${x:%.3d}"   << "7"    << "007";
+	QTest::newRow( "precision width" )    << "${x:%06.3d}" << "-7"   << "  -007";
+	QTest::newRow( "zero precision" )     << "${x:%.0d}"   << "0"    << "";
+	QTest::newRow( "serial" )             << "${x:%08i}"   << "1234" << "00001234";
+	QTest::newRow( "too wide" )           << "${x:%3d}"    << "-12345" << "-12345";
+	QTest::newRow( "upper hex" )          << "${x:%X}"     << "255"  << "FF";
+	QTest::newRow( "octal" )              << "${x:%o}"     << "8"    << "10";
+	QTest::newRow( "unsigned no sign" )   << "${x:%+u}"    << "5"    << "5";
+	QTest::newRow( "string precision" )   << "${x:%5.1s}"  << "abc"  << "    a";
+	QTest::newRow( "string left align" )  << "${x:%-4s}"   << "\u00e9" << "\u00e9   ";
+	QTest::newRow( "float" )              << "${x:%08.2f}" << "-3.14159" << "-0003.14";
+}
+
+
+void TestSubstitutionField::formatFlags()
+{
+	using namespace glabels;
+
+	QFETCH( QString, field );
+	QFETCH( QString, value );
+	QFETCH( QString, expected );
+
+	model::SubstitutionField f( field );
+
+	merge::Record record;
+	record[ "x" ] = value;
+
+	QCOMPARE( f.evaluate( &record, nullptr ), expected );
+}
+
+
 void TestSubstitutionField::newLineEvaluation()
 {
 	using namespace glabels;
@@ -34,6 +34,8 @@ private slots:
 	void formattedStringEvaluation();
 	void formattedFloatEvaluation();
 	void formattedIntEvaluation();
+	void formatFlags_data();
+	void formatFlags();
 	void newLineEvaluation();
 };
 
@@ -155,3 +155,57 @@ void TestVariables::variables()
 	QCOMPARE( vars["s"].value(), QString( "initial" ) );
 	QCOMPARE( vars["c"].value(), QString( "white" ) );
 }
+
+
+void TestVariables::variablesAt()
+{
+	Variables replayed;
+	replayed.addVariable( Variable( Variable::Type::INTEGER, "i", "3", Variable::Increment::PER_ITEM, "3" ) );
+	replayed.addVariable( Variable( Variable::Type::INTEGER, "i2", "100", Variable::Increment::PER_COPY, "-2" ) );
+	replayed.addVariable( Variable( Variable::Type::FLOATING_POINT, "f", "0.0", Variable::Increment::PER_PAGE, "0.1" ) );
+	replayed.addVariable( Variable( Variable::Type::FLOATING_POINT, "f2", "1.5", Variable::Increment::PER_ITEM, "0.3" ) );
+	replayed.addVariable( Variable( Variable::Type::INTEGER, "n", "7", Variable::Increment::NEVER, "1" ) );
+	replayed.addVariable( Variable( Variable::Type::STRING, "s", "initial", Variable::Increment::PER_ITEM, "1" ) );
+
+	Variables direct( &replayed );
+
+	replayed.resetVariables();
+
+	int nItems = 0, nCopies = 0, nPages = 0;
+	for ( int i = 0; i < 50; i++ )
+	{
+		direct.setVariablesAt( nItems, nCopies, nPages );
+		for ( auto& name : replayed.keys() )
+		{
+			QCOMPARE( direct[name].value(), replayed[name].value() );
+		}
+
+		// Advance replayed variables: 1 item per step, a copy every 2nd step, a page every 5th step
+		replayed.incrementVariablesOnItem();
+		nItems++;
+		if ( (i % 2) == 1 )
+		{
+			replayed.incrementVariablesOnCopy();
+			nCopies++;
+		}
+		if ( (i % 5) == 4 )
+		{
+			replayed.incrementVariablesOnPage();
+			nPages++;
+		}
+	}
+
+	direct.setVariablesAt( 10, 4, 2 );
+	QCOMPARE( direct["i"].value(), QString( "33" ) );
+	QCOMPARE( direct["i2"].value(), QString( "92" ) );
+	QCOMPARE( direct["f"].value(), QString( "0.2" ) );
+	QCOMPARE( direct["f2"].value(), QString( "4.5" ) );
+	QCOMPARE( direct["n"].value(), QString( "7" ) );
+	QCOMPARE( direct["s"].value(), QString( "initial" ) );
+
+	direct.setVariablesAt( 0, 0, 0 );
+	QCOMPARE( direct["i"].value(), QString( "3" ) );
+	QCOMPARE( direct["i2"].value(), QString( "100" ) );
+	QCOMPARE( direct["f"].value(), QString( "0" ) );
+	QCOMPARE( direct["f2"].value(), QString( "1.5" ) );
+}
@@ -27,4 +27,5 @@ class TestVariables : public QObject
 
 private slots:
 	void variables();
+	void variablesAt();
 };